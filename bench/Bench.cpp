@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2016 Julien "Derjik" Laurent <julien.laurent@engineer.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "Bench.hpp"
+
+#include <algorithm>	// std::sort
+#include <chrono>	// std::chrono::steady_clock
+#include <iostream>	// std::cerr, std::endl
+#include <iomanip>	// std::setprecision
+
+using namespace std;
+
+
+vector<Bench::Result> Bench::_results;
+string Bench::_filter("");
+unsigned Bench::_minTime(DEFAULT_BENCH_MIN_TIME);
+volatile uint64_t Bench::_sink(0);
+
+
+// Time one call of body(n), in nanoseconds
+static double timeRun(function<void(uint64_t)> const & body, uint64_t const n)
+{
+	chrono::steady_clock::time_point start(chrono::steady_clock::now());
+
+	body(n);
+
+	return chrono::duration_cast<chrono::nanoseconds>(
+		chrono::steady_clock::now() - start).count();
+}
+
+void Bench::configure(string const & filter, unsigned const minTime)
+{
+	_filter = filter;
+	_minTime = minTime;
+}
+
+void Bench::run(string const & name, string const & args,
+		function<void(uint64_t)> const & body)
+{
+	uint64_t iterations(1);
+	double const minTime(_minTime * 1e6);
+	vector<double> times;
+	Result r;
+
+	if((name + "/" + args).find(_filter) == string::npos)
+		return;
+
+	// Calibrate (this also warms the caches up)
+	while(timeRun(body, iterations) < minTime && iterations < (1ull << 40))
+		iterations *= 2;
+
+	for(unsigned i = 0 ; i < BENCH_REPETITIONS ; ++i)
+		times.push_back(timeRun(body, iterations) / iterations);
+	sort(times.begin(), times.end());
+
+	r.name = name;
+	r.args = args;
+	r.iterations = iterations;
+	r.median = times[BENCH_REPETITIONS / 2];
+	r.min = times.front();
+	r.max = times.back();
+	_results.push_back(r);
+
+	cerr << name << "/" << args << ": " << fixed << setprecision(1)
+	<< r.median << " ns/op" << endl;
+}
+
+void Bench::writeJSON(ostream & out)
+{
+	out << "{" << endl << "\t\"repetitions\": " << BENCH_REPETITIONS
+	<< "," << endl << "\t\"benchmarks\": [";
+
+	out << fixed << setprecision(2);
+	for(unsigned i = 0 ; i < _results.size() ; ++i)
+	{
+		Result const & r(_results[i]);
+
+		out << (i == 0 ? "" : ",") << endl << "\t\t{\"name\": \""
+		<< r.name << "\", \"args\": \"" << r.args
+		<< "\", \"iterations\": " << r.iterations
+		<< ", \"ns_per_op\": " << r.median
+		<< ", \"min_ns_per_op\": " << r.min
+		<< ", \"max_ns_per_op\": " << r.max << "}";
+	}
+
+	out << endl << "\t]" << endl << "}" << endl;
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2016 Julien "Derjik" Laurent <julien.laurent@engineer.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef BENCH_HPP_INCLUDED
+#define BENCH_HPP_INCLUDED
+
+#include <cstdint>	// uint64_t
+#include <functional>	// std::function
+#include <ostream>	// std::ostream
+#include <string>	// std::string
+#include <vector>	// std::vector
+
+
+// Timed repetitions of each benchmark (the median is reported)
+#define BENCH_REPETITIONS 5
+// Default minimum duration of one repetition, in milliseconds
+#define DEFAULT_BENCH_MIN_TIME 20
+
+// Output file of the benchmarked writers (Logger, XMLVisitor)
+#ifdef _WIN32
+#define BENCH_NULL_FILE "NUL"
+#else
+#define BENCH_NULL_FILE "/dev/null"
+#endif
+
+
+/*
+ * Minimal micro-benchmark harness.
+ *
+ * A benchmark body runs a given number of operations; the harness doubles
+ * that number until one run lasts long enough, then times several runs and
+ * keeps the median, minimum and maximum time per operation. Results are
+ * written as JSON, keyed by name and arguments, so that two commits can be
+ * compared entry by entry.
+ */
+
+class Bench
+{
+	private:
+		// One benchmark's measures
+		struct Result
+		{
+			std::string name;
+			std::string args;
+			uint64_t iterations;
+			double median;	// ns per operation
+			double min;
+			double max;
+		};
+
+		static std::vector<Result> _results;
+
+		// Only run the benchmarks whose name contains this
+		static std::string _filter;
+		// Minimum duration of one repetition (ms)
+		static unsigned _minTime;
+
+		// Sink keeping values alive through the optimizer
+		static volatile uint64_t _sink;
+
+	public:
+		static void configure(std::string const & filter,
+					unsigned const minTime);
+
+		// Time body(iterations) (args tell the scale, e.g. "25x25/100")
+		static void run(std::string const & name,
+				std::string const & args,
+				std::function<void(uint64_t)> const & body);
+
+		static void writeJSON(std::ostream & out);
+
+		// Mark a computed value as used
+		static void keep(uint64_t const value)
+		{
+			_sink = _sink + value;
+		}
+};
+
+
+// Mandatory forward-declarations
+class Harbor;
+class Point;
+
+// Create the Harbor instance and scatter Military Ships over its surface
+// (returns their positions)
+Harbor * createHarbor(unsigned const size, unsigned const ships,
+			std::vector<Point> & positions);
+
+/*** Benchmark suites (one per source file) ***/
+void benchDie();
+void benchPoint();
+void benchLogger();
+void benchXMLVisitor();
+void benchHarbor();
+void benchTower();
+void benchShipQueue();
+
+#endif // BENCH_HPP_INCLUDED
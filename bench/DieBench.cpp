@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2016 Julien "Derjik" Laurent <julien.laurent@engineer.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "Bench.hpp"
+
+#include "../include/Die.hpp"	// Die, AliasTable
+
+using namespace std;
+
+
+void benchDie()
+{
+	Bench::run("Die::roll(int)", "1-100", [](uint64_t n)
+	{
+		for(uint64_t i = 0 ; i < n ; ++i)
+			Bench::keep(Die::roll(1, 100));
+	});
+
+	Bench::run("Die::roll(float)", "0-1", [](uint64_t n)
+	{
+		for(uint64_t i = 0 ; i < n ; ++i)
+			Bench::keep(Die::roll(0.f, 1.f) < .5f);
+	});
+
+	for(float p : {.01f, .1f, .5f})
+	{
+		Bench::run("Die::rollGeometric", "p=" + to_string(p).substr(0, 4),
+			[p](uint64_t n)
+		{
+			for(uint64_t i = 0 ; i < n ; ++i)
+				Bench::keep(Die::rollGeometric(p));
+		});
+	}
+
+	for(unsigned outcomes : {4u, 64u, 4096u})
+	{
+		vector<float> weights(outcomes);
+
+		for(unsigned i = 0 ; i < outcomes ; ++i)
+			weights[i] = 1 + i % 7;
+
+		AliasTable const table(weights);
+
+		Bench::run("Die::roll(AliasTable)", to_string(outcomes),
+			[&table](uint64_t n)
+		{
+			for(uint64_t i = 0 ; i < n ; ++i)
+				Bench::keep(Die::roll(table));
+		});
+	}
+}
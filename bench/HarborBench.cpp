@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2016 Julien "Derjik" Laurent <julien.laurent@engineer.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "Bench.hpp"
+
+#include "../include/Harbor.hpp"		// Harbor
+#include "../include/LowCostManufactory.hpp"	// LowCostManufactory
+#include "../include/MilitaryShip.hpp"		// MilitaryShip
+#include "../include/PleasureCraft.hpp"	// PleasureCraft
+#include "../include/Die.hpp"			// Die
+
+#include <algorithm>			// std::find, std::swap
+
+using namespace std;
+
+
+// Pre-drawn random indices (drawing them while timing would be measured)
+#define INDICES 4096
+
+// Harbor sides and fleet sizes
+static unsigned const sizes[] = {25, 100, 400};
+static unsigned const fleets[] = {10, 100, 1000};
+
+
+Harbor * createHarbor(unsigned const size, unsigned const ships,
+			vector<Point> & positions)
+{
+	LowCostManufactory f;
+	Harbor * h(nullptr);
+	Point const entry(size / 2, 0);
+	Point p(-1, -1);
+
+	Harbor::deleteInstance();
+	h = Harbor::getInstance(size, size);
+	positions.clear();
+
+	// Enter through the entry point, then jump to a random free cell
+	// (docks' columns and the entry row excluded)
+	for(unsigned i = 0 ; i < ships ; ++i)
+	{
+		do
+			p = Point(Die::roll(1, size - 2), Die::roll(1, size - 1));
+		while(h->getShipAt(p) != nullptr);
+
+		h->addShip(new MilitaryShip(&f), entry);
+		h->moveShip(entry, p);
+		positions.push_back(p);
+	}
+
+	h->clearChangedCells();
+	return h;
+}
+
+void benchHarbor()
+{
+	vector<Point> ships, freeCells;
+	vector<unsigned> indices;
+	LowCostManufactory f;
+	Harbor * h(nullptr);
+
+	for(unsigned i = 0 ; i < INDICES ; ++i)
+		indices.push_back(Die::roll(0, 1 << 30));
+
+	for(unsigned size : sizes)
+	for(unsigned fleet : fleets)
+	{
+		string const args(to_string(size) + "x" + to_string(size) + "/"
+				+ to_string(fleet));
+		Point p(-1, -1);
+
+		if(fleet > size * size / 4)
+			continue;
+
+		h = createHarbor(size, fleet, ships);
+
+		// Free cells to move to (and random lookups)
+		freeCells.clear();
+		while(freeCells.size() < 256)
+		{
+			p = Point(Die::roll(1, size - 2), Die::roll(1, size - 1));
+			if(h->getShipAt(p) == nullptr && find(freeCells.begin(),
+					freeCells.end(), p) == freeCells.end())
+				freeCells.push_back(p);
+		}
+
+		Bench::run("Harbor::getShipAt", args, [&](uint64_t n)
+		{
+			for(uint64_t i = 0 ; i < n ; ++i)
+			{
+				unsigned const j(indices[i % INDICES]);
+				Point const & q(j % 2 ? ships[j % ships.size()]
+						: freeCells[j % freeCells.size()]);
+				Bench::keep(h->getShipAt(q) != nullptr);
+			}
+		});
+
+		// Each move swaps a Ship's cell with a free one
+		Bench::run("Harbor::moveShip", args, [&](uint64_t n)
+		{
+			for(uint64_t i = 0 ; i < n ; ++i)
+			{
+				unsigned const j(indices[i % INDICES] % ships.size());
+				unsigned const k(i % freeCells.size());
+
+				h->moveShip(ships[j], freeCells[k]);
+				swap(ships[j], freeCells[k]);
+				h->clearChangedCells();
+			}
+		});
+
+		Bench::run("Harbor::addShip+removeShip", args, [&](uint64_t n)
+		{
+			Ship const * s(new PleasureCraft(&f));
+			Point const entry(size / 2, 0);
+
+			for(uint64_t i = 0 ; i < n ; ++i)
+			{
+				h->addShip(s, entry);
+				h->removeShip(entry);
+				h->clearChangedCells();
+			}
+
+			delete s;
+		});
+	}
+
+	Harbor::deleteInstance();
+}
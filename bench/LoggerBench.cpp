@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2016 Julien "Derjik" Laurent <julien.laurent@engineer.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "Bench.hpp"
+
+#include "../include/Logger.hpp"	// Logger, custom endl
+#include "../include/Flags.hpp"	// Flags
+#include "../include/Point.hpp"	// Point
+
+using namespace std;
+
+
+// One typical Tower log line at each verbosity (INFO lines are written as
+// long as the verbosity is INFO or DEBUG, filtered out otherwise)
+void benchLogger()
+{
+	Logger log(BENCH_NULL_FILE);
+	string const name("0x55d0c3a4e2f0");
+	Point const p(12, 7);
+
+	for(char const * level : {"DEBUG", "INFO", "WARN", "ERROR", "NONE"})
+	{
+		char const * const args[] = {"bench", "-v", level};
+		Flags::parse(3, args);
+
+		Bench::run("Logger::operator<<", string("verbosity=") + level,
+			[&](uint64_t n)
+		{
+			for(uint64_t i = 0 ; i < n ; ++i)
+				log << info << "Moved Ship " << name << " from "
+				<< p << " to " << p << endl;
+		});
+	}
+
+	// Back to the benchmarks' default
+	char const * const args[] = {"bench", "-v", "NONE"};
+	Flags::parse(3, args);
+}
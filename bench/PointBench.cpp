@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2016 Julien "Derjik" Laurent <julien.laurent@engineer.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "Bench.hpp"
+
+#include "../include/Point.hpp"	// Point, Direction, manhattanDistance()
+#include "../include/Die.hpp"	// Die
+
+using namespace std;
+
+
+// Random Points (within a 1000x1000 surface)
+#define POINTS 1024
+
+void benchPoint()
+{
+	vector<Point> points;
+
+	for(unsigned i = 0 ; i < POINTS ; ++i)
+		points.push_back(Point(Die::roll(0, 999), Die::roll(0, 999)));
+
+	Bench::run("Point::operator string", "", [&points](uint64_t n)
+	{
+		for(uint64_t i = 0 ; i < n ; ++i)
+			Bench::keep(string(points[i % POINTS]).size());
+	});
+
+	Bench::run("Point::operator Direction", "", [&points](uint64_t n)
+	{
+		for(uint64_t i = 0 ; i < n ; ++i)
+			Bench::keep(Direction(points[i % POINTS]
+					- points[(i + 1) % POINTS]));
+	});
+
+	Bench::run("Point::operator+(Direction)", "", [&points](uint64_t n)
+	{
+		Point p(500, 500);
+
+		for(uint64_t i = 0 ; i < n ; ++i)
+			p = p + Direction(i % 4);
+		Bench::keep(p._x + p._y);
+	});
+
+	Bench::run("manhattanDistance", "", [&points](uint64_t n)
+	{
+		for(uint64_t i = 0 ; i < n ; ++i)
+			Bench::keep(manhattanDistance(points[i % POINTS],
+					points[(i + 7) % POINTS]));
+	});
+}
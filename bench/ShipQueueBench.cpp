@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2016 Julien "Derjik" Laurent <julien.laurent@engineer.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "Bench.hpp"
+
+#include "../include/ShipQueue.hpp"		// ShipQueue
+#include "../include/Flags.hpp"		// DEFAULT_QUEUE_AGING
+#include "../include/LowCostManufactory.hpp"	// LowCostManufactory
+#include "../include/PassengerShip.hpp"	// PassengerShip
+#include "../include/MilitaryShip.hpp"		// MilitaryShip
+#include "../include/PleasureCraft.hpp"	// PleasureCraft
+#include "../include/FishingBoat.hpp"		// FishingBoat
+
+using namespace std;
+
+
+// Waiting Ships
+static unsigned const lengths[] = {1000, 100000, 300000};
+
+
+void benchShipQueue()
+{
+	LowCostManufactory f;
+	Ship const * const ships[] = {new PassengerShip(&f),
+		new MilitaryShip(&f), new PleasureCraft(&f),
+		new FishingBoat(&f)};
+
+	for(unsigned length : lengths)
+	{
+		ShipQueue queue(DEFAULT_QUEUE_AGING);
+		uint64_t cycle(0);
+
+		for(unsigned i = 0 ; i < length ; ++i)
+			queue.push(ships[i % 4], cycle++);
+
+		// Steady state: one arrival, one Ship served
+		Bench::run("ShipQueue::push+pop", to_string(length),
+			[&](uint64_t n)
+		{
+			for(uint64_t i = 0 ; i < n ; ++i)
+			{
+				queue.push(ships[(i * 7) % 4], cycle++);
+				Bench::keep(queue.pop() != nullptr);
+			}
+		});
+
+		// The batch assignment's look at the next Ships to serve
+		vector<Ship const *> next;
+		next.reserve(64);
+		queue.reserveNext(64);
+
+		Bench::run("ShipQueue::next(64)", to_string(length),
+			[&](uint64_t n)
+		{
+			for(uint64_t i = 0 ; i < n ; ++i)
+			{
+				next.clear();
+				queue.next(64, next);
+				Bench::keep(next.back() != nullptr);
+			}
+		});
+	}
+
+	for(auto s : ships)
+		delete s;
+}
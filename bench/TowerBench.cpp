@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2016 Julien "Derjik" Laurent <julien.laurent@engineer.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "Bench.hpp"
+
+#include "../include/Tower.hpp"		// Tower
+#include "../include/Harbor.hpp"		// Harbor
+#include "../include/LowCostManufactory.hpp"	// LowCostManufactory
+#include "../include/PleasureCraft.hpp"	// PleasureCraft
+#include "../include/Die.hpp"			// Die
+
+using namespace std;
+
+
+// Harbor sides and fleet sizes
+static unsigned const sizes[] = {25, 100, 400};
+static unsigned const fleets[] = {10, 100, 1000};
+
+
+/*
+ * Access to the Tower's internals
+ */
+
+class TowerBench
+{
+	public:
+		// Plan one step batch, then forget it
+		static bool traceRoute(Tower & t, Point const & source,
+					Point const & dest)
+		{
+			bool moving(t.traceRoute(source, dest));
+			t._plannedMovements.clear();
+			return moving;
+		}
+
+		static bool assignDock(Tower & t, Ship const * const s)
+		{
+			return t.assignDock(s);
+		}
+
+		static Point chooseExit(Tower & t, Point const & source)
+		{
+			return t.chooseExit(source);
+		}
+};
+
+
+void benchTower()
+{
+	vector<Point> ships, docks;
+	LowCostManufactory f;
+
+	for(unsigned size : sizes)
+	for(unsigned fleet : fleets)
+	{
+		string const args(to_string(size) + "x" + to_string(size) + "/"
+				+ to_string(fleet));
+
+		if(fleet > size * size / 4)
+			continue;
+
+		Harbor * h(createHarbor(size, fleet, ships));
+		Tower t(h);
+
+		docks.clear();
+		for(auto dock : h->dockMap())
+			docks.push_back(dock.second);
+
+		Bench::run("Tower::traceRoute", args, [&](uint64_t n)
+		{
+			for(uint64_t i = 0 ; i < n ; ++i)
+				Bench::keep(TowerBench::traceRoute(t,
+					ships[i % ships.size()],
+					docks[i % docks.size()]));
+		});
+
+		Bench::run("Tower::chooseExit", args, [&](uint64_t n)
+		{
+			for(uint64_t i = 0 ; i < n ; ++i)
+				Bench::keep(TowerBench::chooseExit(t,
+					ships[i % ships.size()]).x());
+		});
+
+		// Free docks: the first accepted one is reserved, then freed
+		Bench::run("Tower::assignDock", "free/" + args, [&](uint64_t n)
+		{
+			Ship const * s(new PleasureCraft(&f));
+
+			for(uint64_t i = 0 ; i < n ; ++i)
+			{
+				TowerBench::assignDock(t, s);
+				h->removeReservation(s->name());
+			}
+
+			delete s;
+		});
+
+		// Every dock held by a higher priority Ship: the whole surface
+		// is probed in vain
+		if(fleet < docks.size())
+			continue;
+
+		unsigned i(0);
+		for(auto dock : h->dockMap())
+			h->reserveDock(dock.first,
+				h->getShipAt(ships[i++]));
+
+		Bench::run("Tower::assignDock", "contended/" + args,
+			[&](uint64_t n)
+		{
+			Ship const * s(new PleasureCraft(&f));
+
+			for(uint64_t i = 0 ; i < n ; ++i)
+				Bench::keep(TowerBench::assignDock(t, s));
+
+			delete s;
+		});
+	}
+
+	Harbor::deleteInstance();
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2016 Julien "Derjik" Laurent <julien.laurent@engineer.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "Bench.hpp"
+
+#include "../include/XMLVisitor.hpp"		// XMLVisitor
+#include "../include/LowCostManufactory.hpp"	// LowCostManufactory
+#include "../include/PrestigiousManufactory.hpp"	// PrestigiousManufactory
+#include "../include/PassengerShip.hpp"	// PassengerShip
+#include "../include/MilitaryShip.hpp"		// MilitaryShip
+#include "../include/PleasureCraft.hpp"	// PleasureCraft
+#include "../include/FishingBoat.hpp"		// FishingBoat
+
+using namespace std;
+
+
+// Full Ship description (Ship, Hull and Engine visits)
+void benchXMLVisitor()
+{
+	XMLVisitor xml(BENCH_NULL_FILE);
+	LowCostManufactory lowCost;
+	PrestigiousManufactory prestigious;
+	vector<Ship *> ships;
+
+	ships.push_back(new PassengerShip(&lowCost));
+	ships.push_back(new MilitaryShip(&prestigious));
+	ships.push_back(new PleasureCraft(&lowCost));
+	ships.push_back(new FishingBoat(&prestigious));
+
+	Bench::run("XMLVisitor::visit", "Ship", [&](uint64_t n)
+	{
+		for(uint64_t i = 0 ; i < n ; ++i)
+			ships[i % ships.size()]->accept(&xml);
+	});
+
+	for(auto s : ships)
+		delete s;
+}
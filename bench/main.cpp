@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2016 Julien "Derjik" Laurent <julien.laurent@engineer.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "Bench.hpp"
+
+#include <cstdlib>			// atoi()
+#include <fstream>			// std::ofstream
+#include <iostream>			// std::cout, std::cerr, std::endl
+#include <string>			// std::string
+#include "../include/Flags.hpp"	// Flags
+#include "../include/Die.hpp"		// Die
+
+using namespace std;
+
+
+/*
+ * Benchmarks entry point:
+ *
+ *	bin/bench_<OS> [--filter <substring>] [--min-time <ms>]
+ *			[--out <file.json>]
+ *
+ * The RNGs are never seeded and logging is disabled, so that every run
+ * measures the same workload.
+ */
+
+int main(int argc, char * argv[])
+{
+	char const * const fixed[] = {argv[0], "--no-seed", "-v", "NONE"};
+	string filter(""), out("");
+	unsigned minTime(DEFAULT_BENCH_MIN_TIME);
+
+	for(int i = 1 ; i + 1 < argc ; ++i)
+	{
+		if(string(argv[i]) == "--filter")
+			filter = argv[i+1];
+		else if(string(argv[i]) == "--min-time")
+			minTime = atoi(argv[i+1]);
+		else if(string(argv[i]) == "--out")
+			out = argv[i+1];
+	}
+
+	Flags::parse(4, fixed);
+	Bench::configure(filter, minTime);
+
+	benchDie();
+	benchPoint();
+	benchLogger();
+	benchXMLVisitor();
+	benchHarbor();
+	benchTower();
+	benchShipQueue();
+
+	if(out.empty())
+		Bench::writeJSON(cout);
+	else
+	{
+		ofstream file(out, ios::trunc | ios::out);
+		Bench::writeJSON(file);
+		cerr << "Results written to " << out << endl;
+	}
+
+	Die::clean();
+
+	return 0;
+}
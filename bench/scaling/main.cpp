@@ -0,0 +1,491 @@
+/*
+ * Copyright (c) 2016 Julien "Derjik" Laurent <julien.laurent@engineer.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <algorithm>			// std::find
+#include <chrono>			// std::chrono::steady_clock
+#include <cmath>			// log(), exp()
+#include <cstdlib>			// atoi()
+#include <fstream>			// std::ofstream
+#include <iomanip>			// std::setw, std::setprecision
+#include <iostream>			// std::cout, std::cerr, std::endl
+#include <sstream>			// std::istringstream
+#include <string>			// std::string
+#include <vector>			// std::vector
+#include <sys/resource.h>		// struct rusage
+#include <sys/wait.h>			// wait4()
+#include <unistd.h>			// fork(), pipe(), _exit()
+#include "../../include/Harbor.hpp"		// Harbor
+#include "../../include/Tower.hpp"		// Tower
+#include "../../include/Flags.hpp"		// Flags
+#include "../../include/Die.hpp"		// Die
+#include "../../include/Metrics.hpp"		// Metrics
+#include "../../include/LowCostManufactory.hpp"	// LowCostManufactory
+#include "../../include/PrestigiousManufactory.hpp"	// PrestigiousManufactory
+#include "../../include/PassengerShip.hpp"	// PassengerShip
+#include "../../include/MilitaryShip.hpp"	// MilitaryShip
+#include "../../include/PleasureCraft.hpp"	// PleasureCraft
+#include "../../include/FishingBoat.hpp"	// FishingBoat
+
+using namespace std;
+using namespace std::chrono;
+
+
+// Default matrix ("max" fleets fill every dock)
+#define DEFAULT_SIZES "25,50,100,200,500,1000,2000"
+#define DEFAULT_PROBAS "10,50,100"
+#define DEFAULT_FLEETS "0,100,1000,10000,100000,max"
+#define DEFAULT_MAX_CYCLES 200
+
+
+/*
+ * Macro scaling benchmark: runs whole headless simulations over a matrix of
+ * harbor sides, initial fleets and arrival probabilities, then fits the
+ * empirical complexity of a cycle.
+ *
+ *	bin/scaling_<OS> [--sizes <a,b,...>] [--probas <a,b,...>]
+ *			[--fleets <a,b,...|max>] [--max-cycles <n>]
+ *			[--arrivals <process>] [--routing <strategy>]
+ *			[--out <file.json>]
+ *
+ * Each run happens in a forked child, so that its memory high-water mark
+ * (ru_maxrss) is its own. The child builds a Harbor of the given side,
+ * docks the initial fleet's Ships on random cells (each one holding a dock
+ * reservation, like a Ship entered earlier), then lets the Tower cycle with
+ * the given arrival probability until completion or the cycles limit.
+ * Another arrival process (see -A --arrivals) saturates the entry points;
+ * another routing strategy (see -R --routing) replaces the straight one.
+ *
+ * A Harbor has two docks per row and every Ship on the surface holds one,
+ * so the live fleet can never exceed 2 * side: larger initial fleets are
+ * capped there (and duplicate configurations skipped).
+ *
+ * POSIX only (fork, wait4).
+ */
+
+
+// One run's configuration and measures
+struct Run
+{
+	unsigned size;
+	unsigned proba;
+	unsigned fleet;
+
+	// Sent back by the child
+	struct
+	{
+		uint64_t cycles;
+		uint64_t setup;		// ns
+		uint64_t elapsed;	// ns
+		uint64_t moves;
+		uint64_t created;
+		uint64_t shipCycles;
+	} measures;
+
+	long maxRSS;	// kB
+	bool ok;
+
+	double nsPerCycle() const
+	{
+		return measures.cycles ? double(measures.elapsed)
+			/ measures.cycles : 0.;
+	}
+	double meanFleet() const
+	{
+		return measures.cycles ? double(measures.shipCycles)
+			/ measures.cycles : 0.;
+	}
+	double perSecond(uint64_t const n) const
+	{
+		return measures.elapsed ? n * 1e9 / measures.elapsed : 0.;
+	}
+};
+
+// Least-squares fit of log(y) = log(a) + b * log(x)
+struct Fit
+{
+	double exponent;
+	double factor;
+	double r2;
+	unsigned points;
+};
+
+
+static vector<unsigned> parseList(string const & list, unsigned const max)
+{
+	vector<unsigned> values;
+	istringstream stream(list);
+	string item;
+
+	while(getline(stream, item, ','))
+		values.push_back(item == "max" ? max : atoi(item.c_str()));
+
+	return values;
+}
+
+static Fit fit(vector<double> const & x, vector<double> const & y)
+{
+	Fit f = {0., 0., 0., 0};
+	double sx(0.), sy(0.), sxx(0.), sxy(0.), syy(0.);
+
+	for(unsigned i = 0 ; i < x.size() ; ++i)
+	{
+		if(x[i] <= 0. || y[i] <= 0.)
+			continue;
+
+		double const lx(log(x[i])), ly(log(y[i]));
+		sx += lx;
+		sy += ly;
+		sxx += lx * lx;
+		sxy += lx * ly;
+		syy += ly * ly;
+		++f.points;
+	}
+
+	double const n(f.points);
+	double const vx(n * sxx - sx * sx), vy(n * syy - sy * sy);
+
+	if(f.points < 2 || vx <= 0.)
+		return f;
+
+	f.exponent = (n * sxy - sx * sy) / vx;
+	f.factor = exp((sy - f.exponent * sx) / n);
+	f.r2 = vy > 0. ? (n * sxy - sx * sy) * (n * sxy - sx * sy) / (vx * vy)
+		: 1.;
+
+	return f;
+}
+
+
+// Random Ship, as the Tower would create one
+static Ship const * createShip()
+{
+	LowCostManufactory lowCost;
+	PrestigiousManufactory prestigious;
+	Factory * f(Die::roll(0, 1) ? static_cast<Factory *>(&lowCost)
+				: &prestigious);
+
+	switch(Die::roll(0, 3))
+	{
+		default:
+		case 0: return new PassengerShip(f);
+		case 1: return new MilitaryShip(f);
+		case 2: return new PleasureCraft(f);
+		case 3: return new FishingBoat(f);
+	}
+}
+
+// Dock the initial fleet on random cells (docks' columns and the entry row
+// excluded), each Ship with the first dock it accepts (or any)
+static void populate(Harbor * h, unsigned const size, unsigned const fleet)
+{
+	Point const entry(*h->entryPoints().begin());
+	Point p(-1, -1);
+
+	for(unsigned i = 0 ; i < fleet && !h->availableDocks().empty() ; ++i)
+	{
+		Ship const * s(createShip());
+		unsigned dock(*h->availableDocks().begin());
+
+		do
+			p = Point(Die::roll(1, size - 2), Die::roll(1, size - 1));
+		while(h->getShipAt(p) != nullptr);
+
+		h->addShip(s, entry);
+		h->moveShip(entry, p);
+
+		for(unsigned d : h->availableDocks())
+			if(s->accept(d))
+			{
+				dock = d;
+				break;
+			}
+		h->reserveDock(dock, s);
+	}
+
+	h->clearChangedCells();
+}
+
+// Child side: one simulation, measures written to the given descriptor
+static void simulate(Run & run, unsigned const maxCycles,
+			string const & arrivals, string const & routing,
+			int const fd)
+{
+	string const size(to_string(run.size) + "x" + to_string(run.size));
+	string const cycles(to_string(maxCycles));
+	char const * const args[] = {"scaling", "--no-seed", "-d", "0",
+		"-v", "NONE", "--headless", "--max-cycles", cycles.c_str(),
+		"-S", size.c_str(), "--arrivals", arrivals.c_str(),
+		"--routing", routing.c_str()};
+
+	Flags::parse(sizeof(args) / sizeof(*args), args);
+
+	steady_clock::time_point const start(steady_clock::now());
+	Harbor * h(Harbor::getInstance(run.size, run.size));
+	populate(h, run.size, run.fleet);
+	Tower t(h);
+	steady_clock::time_point const ready(steady_clock::now());
+
+	t.cycle(run.proba);
+	steady_clock::time_point const end(steady_clock::now());
+
+	run.measures.cycles = Metrics::counter(CYCLES);
+	run.measures.setup = duration_cast<nanoseconds>(ready - start).count();
+	run.measures.elapsed = duration_cast<nanoseconds>(end - ready).count();
+	run.measures.moves = Metrics::counter(MOVES);
+	run.measures.created = Metrics::counter(SHIPS_CREATED);
+	run.measures.shipCycles = Metrics::counter(SHIP_CYCLES);
+
+	if(write(fd, &run.measures, sizeof(run.measures))
+			!= sizeof(run.measures))
+		_exit(1);
+
+	// Skip the (large) teardown: the process is discarded anyway
+	_exit(0);
+}
+
+// Parent side: fork, wait and collect
+static void execute(Run & run, unsigned const maxCycles,
+			string const & arrivals, string const & routing)
+{
+	int fds[2];
+	int status(0);
+	struct rusage usage;
+	pid_t pid;
+
+	run.ok = false;
+	run.maxRSS = 0;
+
+	if(pipe(fds) != 0)
+		return;
+
+	cout.flush();
+	pid = fork();
+
+	if(pid == 0)
+	{
+		close(fds[0]);
+		simulate(run, maxCycles, arrivals, routing, fds[1]);
+	}
+
+	close(fds[1]);
+
+	if(pid > 0)
+	{
+		run.ok = read(fds[0], &run.measures, sizeof(run.measures))
+			== sizeof(run.measures);
+
+		if(wait4(pid, &status, 0, &usage) == pid)
+			run.maxRSS = usage.ru_maxrss;
+
+		run.ok = run.ok && WIFEXITED(status)
+			&& WEXITSTATUS(status) == 0;
+	}
+
+	close(fds[0]);
+}
+
+
+static void printRun(Run const & r)
+{
+	cout << setw(6) << r.size << setw(7) << r.proba << setw(8) << r.fleet;
+
+	if(!r.ok)
+	{
+		cout << "  failed" << endl;
+		return;
+	}
+
+	cout << setw(8) << r.measures.cycles
+	<< setw(10) << fixed << setprecision(1) << r.meanFleet()
+	<< setw(12) << setprecision(2) << r.nsPerCycle() / 1e3
+	<< setw(11) << setprecision(0) << r.perSecond(r.measures.moves)
+	<< setw(13) << r.perSecond(r.measures.shipCycles)
+	<< setw(10) << setprecision(1) << r.maxRSS / 1024.
+	<< setw(10) << setprecision(2) << r.measures.setup / 1e6 << endl;
+}
+
+static void printFit(string const & name, Fit const & f)
+{
+	cout << "\t" << left << setw(44) << name << right;
+
+	if(f.points < 2)
+		cout << "not enough points" << endl;
+	else
+		cout << "~ " << setprecision(3) << f.factor << " * x^"
+		<< setprecision(2) << f.exponent << "  (R2 " << f.r2
+		<< ", " << f.points << " points)" << endl;
+}
+
+static void writeJSON(ostream & out, vector<Run> const & runs,
+			unsigned const maxCycles, string const & arrivals,
+			string const & routing,
+			vector<pair<string, Fit>> const & fits)
+{
+	out << "{\n\t\"max_cycles\": " << maxCycles << ",\n\t\"arrivals\": \""
+	<< arrivals << "\",\n\t\"routing\": \"" << routing
+	<< "\",\n\t\"runs\": [";
+
+	for(unsigned i = 0 ; i < runs.size() ; ++i)
+	{
+		Run const & r(runs[i]);
+
+		out << (i ? "," : "") << "\n\t\t{\"size\": " << r.size
+		<< ", \"proba\": " << r.proba << ", \"fleet\": " << r.fleet
+		<< ", \"ok\": " << (r.ok ? "true" : "false");
+
+		if(r.ok)
+			out << ", \"cycles\": " << r.measures.cycles
+			<< ", \"setup_ns\": " << r.measures.setup
+			<< ", \"elapsed_ns\": " << r.measures.elapsed
+			<< ", \"ns_per_cycle\": " << setprecision(1)
+			<< r.nsPerCycle()
+			<< ", \"mean_fleet\": " << setprecision(2)
+			<< r.meanFleet()
+			<< ", \"moves\": " << r.measures.moves
+			<< ", \"ships_created\": " << r.measures.created
+			<< ", \"ship_cycles\": " << r.measures.shipCycles
+			<< ", \"max_rss_kb\": " << r.maxRSS;
+
+		out << "}";
+	}
+
+	out << "\n\t],\n\t\"fits\": [";
+
+	for(unsigned i = 0 ; i < fits.size() ; ++i)
+		out << (i ? "," : "") << "\n\t\t{\"curve\": \""
+		<< fits[i].first << "\", \"exponent\": " << setprecision(3)
+		<< fits[i].second.exponent << ", \"factor\": "
+		<< fits[i].second.factor << ", \"r2\": " << fits[i].second.r2
+		<< ", \"points\": " << fits[i].second.points << "}";
+
+	out << "\n\t]\n}" << endl;
+}
+
+
+int main(int argc, char * argv[])
+{
+	string sizes(DEFAULT_SIZES), probas(DEFAULT_PROBAS),
+		fleets(DEFAULT_FLEETS), arrivals("bernoulli"),
+		routing("straight"), out("");
+	unsigned maxCycles(DEFAULT_MAX_CYCLES);
+	vector<Run> runs;
+	vector<pair<string, Fit>> fits;
+
+	for(int i = 1 ; i + 1 < argc ; ++i)
+	{
+		if(string(argv[i]) == "--sizes")
+			sizes = argv[i+1];
+		else if(string(argv[i]) == "--probas")
+			probas = argv[i+1];
+		else if(string(argv[i]) == "--fleets")
+			fleets = argv[i+1];
+		else if(string(argv[i]) == "--max-cycles")
+			maxCycles = atoi(argv[i+1]);
+		else if(string(argv[i]) == "--arrivals")
+			arrivals = argv[i+1];
+		else if(string(argv[i]) == "--routing")
+			routing = argv[i+1];
+		else if(string(argv[i]) == "--out")
+			out = argv[i+1];
+	}
+
+	cout << "  side  proba   fleet  cycles  mean fleet  us/cycle"
+	<< "    moves/s  ship-cycles/s  RSS (MB) setup (ms)" << endl;
+
+	// Build and run the matrix (fleets capped by the docks)
+	for(unsigned size : parseList(sizes, 0))
+	for(unsigned proba : parseList(probas, 0))
+	{
+		vector<unsigned> done;
+
+		for(unsigned fleet : parseList(fleets, 2 * size))
+		{
+			Run run;
+
+			if(size < 3)
+				continue;
+
+			run.size = size;
+			run.proba = proba;
+			run.fleet = fleet < 2 * size ? fleet : 2 * size;
+
+			if(find(done.begin(), done.end(), run.fleet) != done.end())
+				continue;
+			done.push_back(run.fleet);
+
+			execute(run, maxCycles, arrivals, routing);
+			printRun(run);
+			runs.push_back(run);
+		}
+	}
+
+	// Empirical complexity curves
+	{
+		vector<double> fleet, side, cycle, cells, rss;
+
+		for(Run const & r : runs)
+			if(r.ok)
+			{
+				fleet.push_back(r.meanFleet());
+				cycle.push_back(r.nsPerCycle());
+				cells.push_back(double(r.size) * r.size);
+				rss.push_back(r.maxRSS);
+			}
+		fits.push_back(make_pair("ns/cycle vs mean fleet",
+					fit(fleet, cycle)));
+		fits.push_back(make_pair("max RSS (kB) vs cells",
+					fit(cells, rss)));
+
+		for(unsigned proba : parseList(probas, 0))
+		{
+			side.clear();
+			cycle.clear();
+
+			for(Run const & r : runs)
+				if(r.ok && r.proba == proba
+				&& r.fleet == 2 * r.size)
+				{
+					side.push_back(r.size);
+					cycle.push_back(r.nsPerCycle());
+				}
+
+			fits.push_back(make_pair("ns/cycle vs side (full fleet, "
+				"proba " + to_string(proba) + ")",
+				fit(side, cycle)));
+		}
+	}
+
+	cout << endl << "Empirical complexity:" << endl;
+	for(auto const & f : fits)
+		printFit(f.first, f.second);
+
+	if(!out.empty())
+	{
+		ofstream file(out, ios::trunc | ios::out);
+		writeJSON(file, runs, maxCycles, arrivals, routing, fits);
+		cerr << "Results written to " << out << endl;
+	}
+
+	Die::clean();
+
+	return 0;
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2016 Julien "Derjik" Laurent <julien.laurent@engineer.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef ALLOCATIONS_HPP_INCLUDED
+#define ALLOCATIONS_HPP_INCLUDED
+
+#include <cstdint>	// uint64_t
+
+
+/*
+ * Heap allocation counters.
+ *
+ * The global operator new / delete are replaced (see Allocations.cpp) to
+ * count the allocations and allocated bytes of each thread. Reading them is
+ * cheap enough to be done around every profiled phase.
+ */
+
+class Allocations
+{
+	private:
+		// Current thread's counters
+		static thread_local uint64_t _count;
+		static thread_local uint64_t _bytes;
+
+	public:
+		// Called by the replaced operator new
+		static void record(uint64_t const size)
+		{
+			++_count;
+			_bytes += size;
+		}
+
+		/*** Trivial getters (current thread) ***/
+		static uint64_t count()
+		{
+			return _count;
+		}
+		static uint64_t bytes()
+		{
+			return _bytes;
+		}
+};
+
+#endif // ALLOCATIONS_HPP_INCLUDED
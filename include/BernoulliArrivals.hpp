@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2016 Julien "Derjik" Laurent <julien.laurent@engineer.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef BERNOULLIARRIVALS_HPP_INCLUDED
+#define BERNOULLIARRIVALS_HPP_INCLUDED
+
+#include "ArrivalProcess.hpp"	// ArrivalProcess
+
+
+/*
+ * Bernoulli arrivals (one Ship at most per cycle, with a given probability
+ * in percents)
+ */
+
+class BernoulliArrivals : public ArrivalProcess
+{
+	private:
+		unsigned const _proba;
+
+	public:
+		BernoulliArrivals(unsigned const proba) : _proba(proba) {}
+
+		unsigned arrivals();
+};
+
+#endif // BERNOULLIARRIVALS_HPP_INCLUDED
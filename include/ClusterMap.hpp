@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2016 Julien "Derjik" Laurent <julien.laurent@engineer.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef CLUSTERMAP_HPP_INCLUDED
+#define CLUSTERMAP_HPP_INCLUDED
+
+#include <cstdint>		// uint32_t
+#include <vector>		// std::vector
+
+#include "Point.hpp"		// Point
+#include "JumpPointSearch.hpp"	// JumpPointSearch
+
+
+// Mandatory forward-declarations
+class Harbor;
+
+
+// Side of the square clusters (in cells)
+#define CLUSTER_SIZE 16
+// Entrances at least this wide get a transition at each end (one in their
+// middle otherwise)
+#define CLUSTER_WIDE_ENTRANCE 6
+
+
+/*
+ * Hierarchical route planning (HPA*, Botea, Muller & Schaeffer 2004)
+ * shared by every Ship: the surface is cut into square clusters, linked by
+ * transitions across the free stretches of their borders. The lengths of
+ * the routes between the transitions of each cluster are cached, so that
+ * a long route is found by a search over the transitions only, then
+ * refined one cluster at a time (see ClusterRoute). Every route search is
+ * a JumpPointSearch confined to one cluster; any Ship is an obstacle.
+ *
+ * Clusters are only rebuilt when a cell they own, or one along their
+ * borders, changes: the Tower reports the cells changed by the moves (see
+ * update), the refresh itself happens before the next search.
+ */
+
+class ClusterMap
+{
+	private:
+		struct Cluster
+		{
+			Point topLeft, bottomRight;
+			// Transitions' cells, and the lengths of the routes
+			// between them (UINT32_MAX if none)
+			std::vector<Point> nodes;
+			std::vector<uint32_t> lengths;
+			bool dirty;
+		};
+
+		struct Entry
+		{
+			uint32_t f, g;	// Estimated total and done lengths
+			uint32_t cell;
+		};
+
+		// Heap ordering: "a is served after b" (deepest first on ties)
+		static bool after(Entry const & a, Entry const & b)
+		{
+			return a.f > b.f || (a.f == b.f && (a.g < b.g
+				|| (a.g == b.g && a.cell > b.cell)));
+		}
+
+		Harbor const * _harbor;
+		int const _width, _height;
+		unsigned const _columns, _rows;
+
+		// Occupation of the cells (flattened)
+		std::vector<bool> _blocked;
+
+		std::vector<Cluster> _clusters;
+		std::vector<unsigned> _dirty;
+
+		// Routes within one cluster
+		JumpPointSearch _search;
+
+		// Search over the transitions (per-cell lengths and parents,
+		// stamped), with the lengths from the goal cluster's ones
+		std::vector<uint32_t> _g, _parent;
+		std::vector<uint32_t> _stamp;
+		uint32_t _generation;
+		std::vector<Entry> _heap;
+		std::vector<uint32_t> _toGoal;
+
+		uint32_t index(Point const & p) const
+		{
+			return p.x() + p.y() * _width;
+		}
+		Point point(uint32_t const cell) const
+		{
+			return Point(cell % _width, cell / _width);
+		}
+		bool inside(Point const & p) const
+		{
+			return p.x() >= 0 && p.y() >= 0
+				&& p.x() < _width && p.y() < _height;
+		}
+
+		unsigned cluster(Point const & p) const
+		{
+			return p.x() / CLUSTER_SIZE
+				+ p.y() / CLUSTER_SIZE * _columns;
+		}
+		void touch(unsigned const c);
+		void refresh();
+		void rebuild(Cluster & c);
+		void transitions(Cluster & c, Point const & first,
+				Point const & last, Point const & across);
+		unsigned rank(Cluster const & c, Point const & p) const;
+		void reach(Point const & p, uint32_t const parent,
+				uint32_t const g, Point const & goal);
+
+	public:
+		ClusterMap(Harbor const * const h);
+
+		// Read the whole surface again
+		void reset();
+		// The given cell's occupation changed
+		void update(Point const & cell);
+
+		bool blocked(Point const & p) const
+		{
+			return _blocked[index(p)];
+		}
+
+		// Clusters across the whole surface and down it
+		unsigned columns() const { return _columns; }
+		unsigned rows() const { return _rows; }
+
+		// Transitions to cross from start to goal, the goal first and
+		// the next one last (false if the goal can't be reached)
+		bool find(Point const & start, Point const & goal,
+				std::vector<Point> & waypoints);
+
+		// Cells from start to a waypoint of its cluster or right
+		// across its border, the next one last (false if blocked)
+		bool refine(Point const & start, Point const & waypoint,
+				std::vector<Point> & steps);
+};
+
+#endif // CLUSTERMAP_HPP_INCLUDED
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2016 Julien "Derjik" Laurent <julien.laurent@engineer.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef CLUSTERROUTE_HPP_INCLUDED
+#define CLUSTERROUTE_HPP_INCLUDED
+
+#include <vector>	// std::vector
+
+#include "Point.hpp"	// Point, Direction
+#include "Route.hpp"	// Route
+
+
+// Mandatory forward-declarations
+class ClusterMap;
+
+
+/*
+ * Route of one Ship over a ClusterMap: the transitions to cross, found
+ * once, then the cells to the next one, found when the Ship gets there.
+ * The route is only searched again when the Ship strays from it or a Ship
+ * stands on its next cell.
+ */
+
+class ClusterRoute : public Route
+{
+	private:
+		ClusterMap * _map;
+		Ship const * _ship;
+		Point _goal;
+
+		// Transitions and cells ahead (the next ones last)
+		std::vector<Point> _waypoints;
+		std::vector<Point> _steps;
+		bool _lost;
+
+		void advance(Point const & from);
+
+	public:
+		ClusterRoute(ClusterMap * const map);
+
+		void reset(Ship const * const s, Point const & goal);
+		// (the map is shared: see Tower::repairRoutes)
+		void update(Point const &) {}
+		void plan(Point const & start);
+
+		// (routes run along the transitions: no preferred direction)
+		Point next(Point const & from, Direction const);
+
+		Ship const * ship() const { return _ship; }
+		Point goal() const { return _goal; }
+};
+
+#endif // CLUSTERROUTE_HPP_INCLUDED
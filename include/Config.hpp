@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2016 Julien "Derjik" Laurent <julien.laurent@engineer.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef CONFIG_HPP_INCLUDED
+#define CONFIG_HPP_INCLUDED
+
+#include <string>	// std::string
+#include <vector>	// std::vector
+
+#include "Die.hpp"	// AliasTable
+
+
+/*
+ * Simulation probability tables, optionally loaded from a configuration
+ * file (see -c --config) and compiled into alias tables at startup.
+ *
+ * Each line of the file names a table followed by the (non normalized)
+ * weights of its outcomes, '#' starting a comment:
+ *
+ *	factories		Prestigious, Low Cost
+ *	ships			Passenger, Military, Pleasure, Fishing
+ *	lowcost.engines		Cheap, Turbocharged, Expensive
+ *	lowcost.hulls		Cheap, Gold, Double Gold, Expensive
+ *	prestigious.engines	Expensive, Turbocharged, Nuclear
+ *	prestigious.hulls	Expensive, Gold, Titanium, Gold & Titanium
+ *
+ * Tables missing from the file keep the odds of the original dice:
+ *
+ *	factories		1 1
+ *	ships			1 1 1 1
+ *	lowcost.engines		3 2 1
+ *	lowcost.hulls		3 1 1 1
+ *	prestigious.engines	3 2 1
+ *	prestigious.hulls	3 1 1 1
+ */
+
+class Config
+{
+	private:
+		/*** Probability tables ***/
+		static AliasTable _factories;
+		static AliasTable _ships;
+		static AliasTable _lowCostEngines;
+		static AliasTable _lowCostHulls;
+		static AliasTable _prestigiousEngines;
+		static AliasTable _prestigiousHulls;
+
+		// Get the table associated with the given name (or nullptr)
+		static AliasTable * table(std::string const & name);
+
+	public:
+		// Configuration file parser
+		static void load(std::string const & path);
+
+		/*** Trivial getters ***/
+		static AliasTable const & factories()
+		{
+			return _factories;
+		}
+		static AliasTable const & ships()
+		{
+			return _ships;
+		}
+		static AliasTable const & lowCostEngines()
+		{
+			return _lowCostEngines;
+		}
+		static AliasTable const & lowCostHulls()
+		{
+			return _lowCostHulls;
+		}
+		static AliasTable const & prestigiousEngines()
+		{
+			return _prestigiousEngines;
+		}
+		static AliasTable const & prestigiousHulls()
+		{
+			return _prestigiousHulls;
+		}
+};
+
+#endif // CONFIG_HPP_INCLUDED
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2016 Julien "Derjik" Laurent <julien.laurent@engineer.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef DSTARLITE_HPP_INCLUDED
+#define DSTARLITE_HPP_INCLUDED
+
+#include <cstdint>		// uint32_t
+#include <vector>		// std::vector
+
+#include "Point.hpp"		// Point, Direction
+#include "Route.hpp"		// Route
+
+
+// Mandatory forward-declarations
+class Harbor;
+class Ship;
+
+
+// Cost of entering a cell held by a Ship we can't crush (steps worth of
+// detour accepted to get around it)
+#define DSTAR_OCCUPIED_COST 8
+
+
+/*
+ * Incremental route search of one Ship to its dock (D* Lite, Koenig &
+ * Likhachev 2002): a backward search from the dock whose distances (g)
+ * are repaired, rather than recomputed, when cells change or the Ship
+ * moves. Entering a cell costs 1, or DSTAR_OCCUPIED_COST if a Ship the
+ * searching one can't crush stands there.
+ *
+ * Cells are indexed in flat arrays sized for the whole Harbor once; a new
+ * search only bumps a generation number (cells stamped with an older one
+ * read as unexplored), so that Ships can reuse a pooled instance.
+ */
+
+class DStarLite : public Route
+{
+	private:
+		struct Entry
+		{
+			uint32_t k1, k2;	// Lexicographic key
+			uint32_t cell;
+		};
+
+		// Heap ordering: "a is served after b"
+		static bool after(Entry const & a, Entry const & b)
+		{
+			return a.k1 > b.k1 || (a.k1 == b.k1 && a.k2 > b.k2);
+		}
+
+		Harbor const * _harbor;
+		Ship const * _ship;
+		int const _width, _height;
+
+		// Per-cell distances to the goal (and one-step lookaheads)
+		std::vector<uint32_t> _g, _rhs;
+		std::vector<uint32_t> _stamp;
+		uint32_t _generation;
+
+		// Inconsistent cells (lazy deletion: stale entries are
+		// skipped when they surface)
+		std::vector<Entry> _heap;
+
+		uint32_t _goal, _start, _km;
+
+		uint32_t index(Point const & p) const
+		{
+			return p.x() + p.y() * _width;
+		}
+		Point point(uint32_t const cell) const
+		{
+			return Point(cell % _width, cell / _width);
+		}
+
+		uint32_t g(uint32_t const cell) const;
+		uint32_t rhs(uint32_t const cell) const;
+		void touch(uint32_t const cell);
+
+		uint32_t cost(uint32_t const cell) const;
+		uint32_t heuristic(uint32_t const cell) const;
+		Entry key(uint32_t const cell) const;
+		void updateCell(uint32_t const cell);
+		void computeShortestPath();
+
+		// Neighbours of a cell (returns their number)
+		unsigned neighbours(uint32_t const cell, uint32_t out[4]) const;
+
+	public:
+		DStarLite(Harbor const * const h);
+
+		// Start a new search for the given Ship heading to goal
+		void reset(Ship const * const s, Point const & goal);
+		// The given cell's occupation changed
+		void update(Point const & cell);
+		// Move the search's start and repair the distances
+		void plan(Point const & start);
+
+		// Next cell on the way to the goal from the given cell (the
+		// preferred direction wins ties), from itself if unreachable
+		Point next(Point const & from, Direction const preferred);
+
+		Ship const * ship() const { return _ship; }
+		Point goal() const { return point(_goal); }
+};
+
+#endif // DSTARLITE_HPP_INCLUDED
@@ -25,13 +25,44 @@
 
 #include <random>	// std::default_random_engine, std::random_device,
 			// std::uniform_int_distribution,
-			// std::uniform_real_distribution
+			// std::uniform_real_distribution,
+			// std::geometric_distribution,
+			// std::poisson_distribution
+#include <vector>	// std::vector
+
+
+/*
+ * Walker alias table: compiles a set of (non normalized) weights into
+ * a table from which categorical draws take constant time, whatever the
+ * number of outcomes or their respective weights.
+ */
+
+class AliasTable
+{
+	private:
+		// Probability of keeping each column's own outcome
+		std::vector<float> _probability;
+		// Outcome to use instead when the column's one is rejected
+		std::vector<unsigned> _alias;
+
+	public:
+		// Constructor (weights must be >= 0, with a positive sum)
+		AliasTable(std::vector<float> const & weights);
+
+		unsigned size() const { return _alias.size(); }
+		float probability(unsigned const i) const
+		{
+			return _probability[i];
+		}
+		unsigned alias(unsigned const i) const { return _alias[i]; }
+};
 
 
 /*
  * Random Number Generation utility.
  * Just get a die and roll it with integer or floating point min / max values.
- * Auto inits itself at first use.
+ * Auto inits itself at first use. Every draw goes through the Scenario
+ * recorder / player (see Scenario.hpp).
  */
 
 class Die
@@ -49,6 +80,21 @@ class Die
 		// Roll methods (inclusive)
 		static int roll(int const min, int const max);
 		static float roll(float const min, float const max);
+
+		// Number of successful trials before the first failure, given
+		// the failure probability p of each trial
+		static unsigned rollGeometric(float const p);
+
+		// Number of events during one period, given their mean number
+		// per period (Poisson distribution)
+		static unsigned rollPoisson(float const mean);
+
+		// Draw an outcome index (0 to t.size()-1) from an alias table
+		static unsigned roll(AliasTable const & t);
+
+		// Draw an index (0 to n-1) from the C library's rand() stream,
+		// as std::random_shuffle does by default
+		static int rollLegacy(int const n);
 };
 
 #endif // DIE_HPP_INCLUDED
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2016 Julien "Derjik" Laurent <julien.laurent@engineer.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef DOCKMATCHER_HPP_INCLUDED
+#define DOCKMATCHER_HPP_INCLUDED
+
+#include <vector>	// std::vector
+
+
+// Cost of a forbidden pair (a dock the Ship doesn't accept)
+#define DOCK_MATCHER_FORBIDDEN 1000000000LL
+
+
+/*
+ * Min-cost bipartite matching (Hungarian algorithm, shortest augmenting
+ * paths with potentials) between rows (Ships) and at least as many
+ * columns (docks): every row gets a distinct column, for the lowest total
+ * cost. O(rows^2 * columns); buffers are kept from one solve to the next.
+ */
+
+class DockMatcher
+{
+	private:
+		unsigned _rows;
+		unsigned _columns;
+
+		// Row-major costs
+		std::vector<long long> _costs;
+
+		// Potentials, matching, search state (1-based, 0 is a
+		// virtual column)
+		std::vector<long long> _u, _v, _minv;
+		std::vector<unsigned> _p, _way;
+		std::vector<bool> _used;
+
+		// Column of each row
+		std::vector<unsigned> _assignment;
+
+	public:
+		DockMatcher() : _rows(0), _columns(0) {}
+
+		// Size the buffers for the largest expected problem
+		void reserve(unsigned const rows, unsigned const columns);
+
+		// Start a new problem (rows <= columns)
+		void reset(unsigned const rows, unsigned const columns);
+
+		void setCost(unsigned const row, unsigned const column,
+				long long const cost)
+		{
+			_costs[row * _columns + column] = cost;
+		}
+		long long cost(unsigned const row, unsigned const column) const
+		{
+			return _costs[row * _columns + column];
+		}
+
+		void solve();
+
+		// Column matched with the given row (once solved)
+		unsigned column(unsigned const row) const
+		{
+			return _assignment[row];
+		}
+};
+
+#endif // DOCKMATCHER_HPP_INCLUDED
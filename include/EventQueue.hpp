@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2016 Julien "Derjik" Laurent <julien.laurent@engineer.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef EVENTQUEUE_HPP_INCLUDED
+#define EVENTQUEUE_HPP_INCLUDED
+
+#include <cstdint>	// uint64_t
+#include <vector>	// std::vector
+
+
+// Mandatory forward-declarations
+class Ship;
+
+
+// Kinds of events, in their processing order within a cycle
+enum EventType
+{
+	MOVE,		// A travelling Ship plans and applies its moves
+	DOCKING,	// A Ship reached its reserved dock
+	ARRIVAL		// Ships show up (count known or still to draw)
+};
+
+
+/*
+ * Timestamped events of the discrete-event Tower loop (see
+ * Tower::runEvents), kept in a binary heap (in a vector) on their cycle,
+ * then their type, then their insertion rank, so that events sharing a
+ * cycle are served in a reproducible order.
+ *
+ * Ship events may outlive their Ship (crushed or evicted meanwhile): the
+ * Tower checks the Ship is still on the surface before handling them.
+ */
+
+struct Event
+{
+	uint64_t cycle;
+	EventType type;
+	Ship const * ship;	// MOVE and DOCKING
+	unsigned count;		// ARRIVAL (0 means "draw it then")
+};
+
+class EventQueue
+{
+	private:
+		struct Entry
+		{
+			Event event;
+			uint64_t order;	// insertion rank (ties)
+		};
+
+		// Heap ordering: "a is served after b"
+		static bool after(Entry const & a, Entry const & b)
+		{
+			return a.event.cycle > b.event.cycle
+				|| (a.event.cycle == b.event.cycle
+				&& (a.event.type > b.event.type
+				|| (a.event.type == b.event.type
+				&& a.order > b.order)));
+		}
+
+		std::vector<Entry> _heap;
+		uint64_t _pushed;
+
+	public:
+		EventQueue() : _pushed(0) {}
+
+		// Schedule an event
+		void push(Event const & e);
+		// Remove and return the next event (queue not empty)
+		Event pop();
+
+		// Next event (queue not empty)
+		Event const & top() const { return _heap.front().event; }
+
+		unsigned size() const { return _heap.size(); }
+		bool empty() const { return _heap.empty(); }
+
+		// Size the heap for that many pending events
+		void reserve(unsigned const n) { _heap.reserve(n); }
+};
+
+#endif // EVENTQUEUE_HPP_INCLUDED
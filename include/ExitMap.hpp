@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2016 Julien "Derjik" Laurent <julien.laurent@engineer.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef EXITMAP_HPP_INCLUDED
+#define EXITMAP_HPP_INCLUDED
+
+#include <cstdint>	// uint32_t
+#include <set>		// std::set
+#include <vector>	// std::vector
+
+#include "Point.hpp"	// Point
+
+
+/*
+ * Nearest exit of every cell of a Harbor: a breadth-first search started
+ * from all the exits at once labels each cell with the exit it reaches
+ * first and the number of steps (4-connected) to it. Built once per
+ * layout, it answers in constant time, for any number of exits on any
+ * side. Ties go to the exit coming first in the set.
+ */
+
+class ExitMap
+{
+	private:
+		int _width, _height;
+
+		// Exits, in the set's order (ranks)
+		std::vector<Point> _exits;
+
+		// Per-cell rank of the nearest exit and distance to it
+		std::vector<uint32_t> _nearest;
+		std::vector<uint32_t> _distance;
+
+		uint32_t index(Point const & p) const
+		{
+			return p.x() + p.y() * _width;
+		}
+		bool inside(Point const & p) const
+		{
+			return p.x() >= 0 && p.y() >= 0
+				&& p.x() < _width && p.y() < _height;
+		}
+
+	public:
+		ExitMap();
+
+		// Label the cells of a width x height surface
+		void build(unsigned const width, unsigned const height,
+				std::set<Point> const & exits);
+
+		// Nearest exit of a cell, its rank and the steps to reach it
+		Point exit(Point const & p) const
+		{
+			return _exits[_nearest[index(p)]];
+		}
+		unsigned rank(Point const & p) const
+		{
+			return _nearest[index(p)];
+		}
+		unsigned distance(Point const & p) const
+		{
+			return _distance[index(p)];
+		}
+
+		// Neighbours on the way to the cell's nearest exit that are one
+		// step closer to an exit, along the largest remaining delta
+		// first (returns their number)
+		unsigned downhill(Point const & p, Point out[2]) const;
+};
+
+#endif // EXITMAP_HPP_INCLUDED
@@ -24,8 +24,13 @@
 #define FLAGS_HPP_INCLUDED
 
 #include <string>	// std::string
+#include <vector>	// std::vector
 
 #define DEFAULT_CYCLE_DELAY 150
+#define DEFAULT_HARBOR_SIZE 25
+#define DEFAULT_METRICS_PERIOD 10
+#define DEFAULT_QUEUE_AGING 0.1f
+#define DEFAULT_WATCHDOG 10000
 
 // Logging level
 enum LogLevel
@@ -33,7 +38,25 @@ enum LogLevel
 	DEBUG	=0,
 	INFO	=1,
 	WARN	=2,
-	ERROR	=3
+	ERROR	=3,
+	NONE	=4	// Logging disabled
+};
+
+// Ship arrival process (see ArrivalProcess.hpp)
+enum ArrivalModel
+{
+	BERNOULLI,	// At most one Ship per cycle, with the cycle's probability
+	POISSON,	// Poisson distributed Ships per cycle
+	MMPP,		// Poisson, with a rate switching between two states
+	SCHEDULE	// Fixed numbers of Ships per cycle, repeated
+};
+
+// Route planning strategy (see Tower::traceRoute)
+enum Routing
+{
+	STRAIGHT,	// Straight towards the destination, largest delta first
+	DSTAR,		// Incremental shortest routes (see DStarLite.hpp)
+	HPA		// Hierarchical routes (see ClusterMap.hpp)
 };
 
 
@@ -56,8 +79,109 @@ enum LogLevel
  *		Set the delay (in milliseconds) between two
  *		Tower cycles
  *
- *	-v --verbosity <DEBUG|INFO|WARN|ERROR>
- *		Set the logging verbosity
+ *	-v --verbosity <DEBUG|INFO|WARN|ERROR|NONE>
+ *		Set the logging verbosity (NONE disables logging)
+ *
+ *	-c --config <file>
+ *		Load the Ship and Factory probability tables from
+ *		the given file (see Config.hpp for its format)
+ *
+ *	-S --size <width>x<height>
+ *		Set the Harbor's dimensions (in cells, at least 3
+ *		columns so that ships enter between the docks)
+ *
+ *	-V --view <columns>x<rows>
+ *		Only display a viewport of the given dimensions (in
+ *		cells, defaults to the terminal's size)
+ *
+ *	-z --zoom <unsigned integer>
+ *		Display blocks of zoom x zoom cells as density
+ *		glyphs (0 zooms out until the whole Harbor fits)
+ *
+ *	-f --follow
+ *		Keep a moving Ship centered in the viewport
+ *
+ *	-m --metrics <prefix>
+ *		Export the simulation metrics to <prefix>.prom
+ *		(Prometheus text format) and <prefix>.csv
+ *
+ *	--metrics-period <unsigned integer>
+ *		Set the number of Tower cycles between two metrics
+ *		exports (0 only exports at the end of the run)
+ *
+ *	-p --profile
+ *		Time each Tower cycle phase and print their p50, p99
+ *		and max durations at the end of the run
+ *
+ *	-t --trace <file>
+ *		Write a Chrome trace-event JSON timeline of the cycle
+ *		phases, routes, dock assignments and frames to <file>
+ *
+ *	-Z --zero-alloc
+ *		Disable logging and fail (exit code 1) if any cycle
+ *		phase but Ship creation allocates heap memory once
+ *		warmed up
+ *
+ *	-H --headless
+ *		Don't display anything (simulation only)
+ *
+ *	--max-cycles <unsigned integer>
+ *		Stop each Tower loop after that many cycles (0 means
+ *		"until completion")
+ *
+ *	--record <file>
+ *		Record every random draw and each cycle's state hash to
+ *		<file>
+ *
+ *	--replay <file>
+ *		Replay the draws recorded in <file> instead of rolling
+ *		them, and fail (exit code 1) if the state diverges
+ *
+ *	-A --arrivals <process>
+ *		Set the Ship arrival process:
+ *		bernoulli (default): one Ship at most per cycle
+ *		poisson:<rate>: <rate> Ships per cycle on average
+ *		mmpp:<rate1>,<rate2>,<p12>,<p21>: bursty Poisson, switching
+ *		from rate 1 to rate 2 with probability <p12> per cycle
+ *		(and back with <p21>)
+ *		schedule:<n1>,<n2>,...: <n1> Ships on the first cycle,
+ *		<n2> on the second... then over again
+ *
+ *	--aging <positive or null float>
+ *		Priority points gained by a waiting Ship per cycle spent
+ *		in the queue (0 means "strict priority order")
+ *
+ *	--batch-docks <unsigned integer>
+ *		Every that many cycles, reassign the docks of the Ships
+ *		still travelling (and of the next queued ones) so as to
+ *		minimize the priority-weighted travel distance (0 means
+ *		"first accepted dock only")
+ *
+ *	-E --events
+ *		Run the filling cycle as a discrete-event simulation:
+ *		only the Ships with pending events are handled, and idle
+ *		cycles are skipped
+ *
+ *	-R --routing <strategy>
+ *		Set the route planning strategy:
+ *		straight (default): head straight to the destination
+ *		dstar: shortest route around the Ships that can't be
+ *		crushed, repaired incrementally as the surface changes
+ *		hpa: route around every Ship across clusters of cells,
+ *		for the largest harbors
+ *
+ *	--watchdog <unsigned integer>
+ *		End the run (exit code 1) once that many cycles in a row
+ *		went by without any Ship docking or leaving while Ships
+ *		still had to move (a livelock, see Tower::watch; 0 means
+ *		"never", defaults to 10000)
+ *
+ *	--congestion <positive or null float>
+ *		Weight of the recent traffic through a cell (see
+ *		HeatMap) when a straight-routed Ship picks its next step:
+ *		it takes the other way to its destination when that way
+ *		is less busy by more than one step's worth (0 means
+ *		"ignore the traffic")
  */
 
 class Flags
@@ -76,10 +200,61 @@ class Flags
 		static bool _help;
 		// Sets the minimum verbosity level to be displayed
 		static LogLevel _logLevel;
+		// Path to the probability tables configuration file
+		static std::string _configFile;
+		// Harbor's dimensions
+		static unsigned _harborWidth;
+		static unsigned _harborHeight;
+		// Viewport dimensions (0 means "terminal's size")
+		static unsigned _viewColumns;
+		static unsigned _viewRows;
+		// Display zoom (1 means "one cell per symbol", 0 "fit")
+		static unsigned _zoom;
+		// Indicates wether the viewport should follow a Ship
+		static bool _follow;
+		// Metrics export files prefix (empty means "disabled")
+		static std::string _metricsPrefix;
+		// Tower cycles between two metrics exports
+		static unsigned _metricsPeriod;
+		// Indicates wether cycle phases should be timed
+		static bool _profile;
+		// Timeline output file (empty means "disabled")
+		static std::string _traceFile;
+		// Indicates wether steady-state allocations are forbidden
+		static bool _zeroAllocations;
+		// Indicates wether the display is disabled
+		static bool _headless;
+		// Cycles limit of each Tower loop (0 means "none")
+		static unsigned _maxCycles;
+		// Scenario to record to / replay from (none if empty)
+		static std::string _recordFile;
+		static std::string _replayFile;
+		// Ship arrival process and its parameters
+		static ArrivalModel _arrivalModel;
+		static std::vector<float> _arrivalParameters;
+		// Waiting queue aging (priority points per cycle)
+		static float _queueAging;
+		// Cycles between two batch dock assignments (0 means "none")
+		static unsigned _dockBatchPeriod;
+		// Indicates wether the filling cycle is event-driven
+		static bool _events;
+		// Route planning strategy
+		static Routing _routing;
+		// Weight of the traffic heat in the straight routing
+		static float _congestion;
+		// Stalled cycles ending a cycle loop (livelock watchdog)
+		static unsigned _watchdog;
 
 		/*** Sub-parsers ***/
 		static void parseCycleDelay(std::string const &);
 		static void parseLogLevel(std::string const &);
+		static bool parseDimensions(std::string const &,
+					unsigned &, unsigned &, unsigned const);
+		static void parseZoom(std::string const &);
+		static bool parseArrivals(std::string const &);
+		static bool parseRouting(std::string const &);
+		static bool parseUnsigned(std::string const &, unsigned &);
+		static bool parseFloat(std::string const &, float &);
 
 	public:
 		// Main arguments parser
@@ -114,6 +289,102 @@ class Flags
 		{
 			return _logLevel;
 		}
+		static std::string const & configFile()
+		{
+			return _configFile;
+		}
+		static unsigned harborWidth()
+		{
+			return _harborWidth;
+		}
+		static unsigned harborHeight()
+		{
+			return _harborHeight;
+		}
+		static unsigned viewColumns()
+		{
+			return _viewColumns;
+		}
+		static unsigned viewRows()
+		{
+			return _viewRows;
+		}
+		static unsigned zoom()
+		{
+			return _zoom;
+		}
+		static bool follow()
+		{
+			return _follow;
+		}
+		static std::string const & metricsPrefix()
+		{
+			return _metricsPrefix;
+		}
+		static unsigned metricsPeriod()
+		{
+			return _metricsPeriod;
+		}
+		static bool profile()
+		{
+			return _profile;
+		}
+		static std::string const & traceFile()
+		{
+			return _traceFile;
+		}
+		static bool zeroAllocations()
+		{
+			return _zeroAllocations;
+		}
+		static bool headless()
+		{
+			return _headless;
+		}
+		static unsigned maxCycles()
+		{
+			return _maxCycles;
+		}
+		static std::string const & recordFile()
+		{
+			return _recordFile;
+		}
+		static std::string const & replayFile()
+		{
+			return _replayFile;
+		}
+		static ArrivalModel arrivalModel()
+		{
+			return _arrivalModel;
+		}
+		static std::vector<float> const & arrivalParameters()
+		{
+			return _arrivalParameters;
+		}
+		static float queueAging()
+		{
+			return _queueAging;
+		}
+		static unsigned dockBatchPeriod()
+		{
+			return _dockBatchPeriod;
+		}
+		static bool events()
+		{
+			return _events;
+		}
+		static Routing routing()
+		{
+			return _routing;
+		}
+		static float congestion()
+		{
+			return _congestion;
+		}
+		static unsigned watchdog()
+		{
+			return _watchdog;
+		}
 };
 
 #endif // FLAGS_HPP_INCLUDED
@@ -23,12 +23,25 @@
 #ifndef HARBOR_HPP_INCLUDED
 #define HARBOR_HPP_INCLUDED
 
+#include <cstdint>	// uint64_t
 #include <map>		// std::map
 #include <set>		// std::set
+#include <vector>	// std::vector
 
 #include "Ship.hpp"	// Ship
 #include "Point.hpp"	// Point
 #include "Logger.hpp"	// Logger, custom endl
+#include "Pool.hpp"	// PoolAllocator, reserveNodes
+#include "PreemptionIndex.hpp"	// PreemptionIndex
+#include "ExitMap.hpp"	// ExitMap
+#include "HeatMap.hpp"	// HeatMap
+
+
+// Containers updated every cycle recycle their nodes (see Pool.hpp)
+typedef std::map<Point, Ship const *, std::less<Point>,
+	PoolAllocator<std::pair<Point const, Ship const *>>> Surface;
+typedef std::set<unsigned, std::less<unsigned>,
+	PoolAllocator<unsigned>> DockSet;
 
 
 /*
@@ -47,16 +60,24 @@ class Harbor
 		Logger _log;
 
 		// Harbor's matrix (linking coordinates to Ship pointers)
-		std::map<Point, Ship const *> _surface;
+		Surface _surface;
 		// Reverse matrix (used for Ship location purposes)
 		std::map<Ship const *, Point> _reverseSurface;
+		// Cells changed since the last clearChangedCells() call
+		std::vector<Point> _changedCells;
 		// Harbor's width
 		unsigned _width;
 		// Harbor's height
 		unsigned _height;
+		// Sum of the surface's Ships speeds
+		unsigned long _totalSpeed;
+		// Traffic through each cell
+		HeatMap _heat;
 
 		// Harbor's entry points
 		std::set<Point> _entryPoints;
+		// Nearest entry point of every cell
+		ExitMap _exitMap;
 
 		// Dock mapping (linking dock IDs to coordinates)
 		std::map<unsigned, Point> _docks;
@@ -67,7 +88,10 @@ class Harbor
 		std::map<std::string, unsigned> _reservations;
 
 		// Docks available for reservation
-		std::set<unsigned> _availableDocks;
+		DockSet _availableDocks;
+
+		// Reservation holders, by priority (evictions)
+		PreemptionIndex _preemption;
 
 		/*** Constructor & destructor ***/
 		Harbor(unsigned const width=40, unsigned const height=20);
@@ -100,29 +124,50 @@ class Harbor
 		bool removeShip(Ship const * p);
 
 		std::set<Point> const & entryPoints() const;
+		ExitMap const & exitMap() const;
 
-		std::map<Point, Ship const *> const & surface() const;
+		Surface const & surface() const;
 		std::map<Ship const *, Point> const & reverseSurface() const;
+		unsigned long totalSpeed() const;
+
+		std::vector<Point> const & changedCells() const;
+		void clearChangedCells();
+
+		HeatMap const & heat() const;
+		void coolDown(uint64_t const cycle);
 
 
 		/*** Docks-related methods ***/
 		Point getDockPosition(unsigned const id) const;
 
-		std::set<unsigned> const & availableDocks() const;
+		DockSet const & availableDocks() const;
 
 		bool reserveDock(unsigned const dockId, Ship const * const s);
 		bool reserveDock(unsigned const dockId, Ship const & s);
 
 		bool removeReservation(std::string const & s);
 
+		// Swap reservations around: each given Ship (holding a dock)
+		// gets the given dock, free or held by another given Ship
+		void reassignDocks(std::vector<std::pair<Ship const *,
+						unsigned>> const & changes);
+
 		unsigned getReservedDock(Ship const * const s) const;
 		unsigned getReservedDock(Ship const & s) const;
 
+		// Lower priority Ship holding the best dock to take over for
+		// the given Ship (nullptr if none, see PreemptionIndex)
+		Ship const * evictionCandidate(Ship const * const s);
+
 		std::map<unsigned, Point> const & dockMap() const;
 		std::map<Point, unsigned> const & reverseDockMap() const;
 
 		/*** Display-related methods ***/
 		void display() const;
+
+		/*** Replay-related methods ***/
+		// Hash of the Ships' positions, names and reservations
+		uint64_t stateHash() const;
 };
 
 /*
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2016 Julien "Derjik" Laurent <julien.laurent@engineer.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef HEATMAP_HPP_INCLUDED
+#define HEATMAP_HPP_INCLUDED
+
+#include <cstdint>	// uint64_t
+#include <vector>	// std::vector
+
+#include "Point.hpp"	// Point
+
+
+// Share of a cell's heat kept from one cycle to the next
+#define HEAT_DECAY 0.9f
+// Scale at which the stored heat is brought back to its actual values
+#define HEAT_RESCALE 1e12f
+
+
+/*
+ * Traffic heat of every cell: each Ship entering a cell adds 1 to its
+ * heat, which then decays exponentially with the cycles.
+ *
+ * One float per cell. Decaying every cell each cycle would cost as much as
+ * the surface: the heat is stored scaled up instead, by a factor growing
+ * as the heat should decay (deposits are scaled up alike, reads scaled
+ * down), and only brought back once the factor gets too large.
+ */
+
+class HeatMap
+{
+	private:
+		unsigned _width;
+		std::vector<float> _cells;
+		float _scale;
+		uint64_t _cycle;
+
+	public:
+		HeatMap();
+
+		void resize(unsigned const width, unsigned const height);
+
+		// Let the heat decay until the given cycle
+		void advance(uint64_t const cycle);
+
+		// A Ship entered the given cell
+		void add(Point const & p)
+		{
+			_cells[p.x() + p.y() * _width] += _scale;
+		}
+
+		float at(Point const & p) const
+		{
+			return _cells[p.x() + p.y() * _width] / _scale;
+		}
+};
+
+#endif // HEATMAP_HPP_INCLUDED
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2016 Julien "Derjik" Laurent <julien.laurent@engineer.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef JUMPPOINTSEARCH_HPP_INCLUDED
+#define JUMPPOINTSEARCH_HPP_INCLUDED
+
+#include <cstdint>	// uint32_t
+#include <vector>	// std::vector
+
+#include "Point.hpp"	// Point
+
+
+/*
+ * Shortest routes on a uniform-cost grid (4-connected), confined to a
+ * rectangle: A* over jump points (Harabor & Grastien 2011, with vertical
+ * moves coming first on the canonical routes). A search jumps along the
+ * straight lines and only stops where a turn may be needed (a cell freed
+ * by an obstacle just behind, or one from which a horizontal jump reaches
+ * such a cell or the goal), so that open areas cost almost nothing.
+ *
+ * Blocked cells are read from a shared flattened grid. The search state
+ * is stamped like DStarLite's, and sized once for the largest rectangle.
+ */
+
+class JumpPointSearch
+{
+	private:
+		struct Entry
+		{
+			uint32_t f, g;	// Estimated total and done lengths
+			uint32_t cell;	// Within the rectangle
+		};
+
+		// Heap ordering: "a is served after b" (deepest first on ties)
+		static bool after(Entry const & a, Entry const & b)
+		{
+			return a.f > b.f || (a.f == b.f && (a.g < b.g
+				|| (a.g == b.g && a.cell > b.cell)));
+		}
+
+		std::vector<bool> const & _blocked;
+		int const _width;
+
+		// Current search
+		int _left, _top, _right, _bottom;
+		Point _start, _goal;
+
+		// Per-cell of the rectangle lengths and parents
+		std::vector<uint32_t> _g, _parent;
+		std::vector<uint32_t> _stamp;
+		uint32_t _generation;
+		std::vector<Entry> _heap;
+
+		uint32_t index(Point const & p) const
+		{
+			return (p.x() - _left) + (p.y() - _top)
+				* (_right - _left + 1);
+		}
+		Point point(uint32_t const cell) const
+		{
+			return Point(_left + cell % (_right - _left + 1),
+					_top + cell / (_right - _left + 1));
+		}
+
+		bool free(int const x, int const y) const;
+		bool jumpHorizontal(Point const & from, int const dx,
+					Point & jump) const;
+		bool jumpVertical(Point const & from, int const dy,
+					Point & jump) const;
+		void reach(Point const & p, uint32_t const parent,
+				uint32_t const g);
+
+	public:
+		// Blocked cells of a grid of the given width, rectangles of
+		// the given area at most
+		JumpPointSearch(std::vector<bool> const & blocked,
+				unsigned const width, unsigned const area);
+
+		// Length of the shortest route from start to goal within the
+		// given corners, UINT32_MAX if there's none (its cells, start
+		// excluded, are then appended to path, if any)
+		uint32_t find(Point const & start, Point const & goal,
+				Point const & topLeft, Point const & bottomRight,
+				std::vector<Point> * const path = nullptr);
+};
+
+#endif // JUMPPOINTSEARCH_HPP_INCLUDED
@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2016 Julien "Derjik" Laurent <julien.laurent@engineer.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef MMPPARRIVALS_HPP_INCLUDED
+#define MMPPARRIVALS_HPP_INCLUDED
+
+#include "ArrivalProcess.hpp"	// ArrivalProcess
+
+
+/*
+ * Two-state Markov-modulated Poisson arrivals (bursty traffic): Poisson
+ * arrivals whose rate switches between two values, the state changing at
+ * each cycle with a given probability.
+ */
+
+class MMPPArrivals : public ArrivalProcess
+{
+	private:
+		// Rate of each state
+		float const _rates[2];
+		// Probability of leaving each state, per cycle
+		float const _switch[2];
+
+		// Current state (starts in the first one)
+		unsigned _state;
+
+	public:
+		MMPPArrivals(float const rate1, float const rate2,
+				float const p12, float const p21)
+			: _rates{rate1, rate2}, _switch{p12, p21}, _state(0) {}
+
+		unsigned arrivals();
+};
+
+#endif // MMPPARRIVALS_HPP_INCLUDED
@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2016 Julien "Derjik" Laurent <julien.laurent@engineer.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef METRICS_HPP_INCLUDED
+#define METRICS_HPP_INCLUDED
+
+#include <atomic>	// std::atomic
+#include <cstdint>	// uint64_t
+#include <mutex>	// std::mutex
+#include <string>	// std::string
+#include <vector>	// std::vector
+
+
+// Counted events
+enum Counter
+{
+	MOVES,			// Moves applied onto the surface
+	COLLISIONS,		// Ships crushed during a move
+	BLOCKED_MOVES,		// Moves refused because of a stronger Ship
+	STAY_PUTS,		// Planned steps waiting behind an obstacle
+	ENGINE_FAILURES,	// Planned steps lost to an engine failure
+	EVICTIONS,		// Reservations taken over by a higher priority
+	SHIPS_CREATED,		// Ships built by the Tower
+	SHIPS_REJECTED,		// Ships deleted for lack of a suitable dock
+	SHIPS_DEPARTED,		// Ships which left the Harbor
+	CYCLES,			// Tower cycles
+	SHIP_CYCLES,		// Ships on the surface, summed over cycles
+	TURNED_AWAY,		// Arrivals dropped (every dock already promised)
+	REASSIGNMENTS,		// Reservations moved (batch assignment, deadlocks)
+	ROUTE_EXPANSIONS,	// Cells expanded by the route searches
+	DEADLOCKS,		// Wait cycles and endless waits broken
+	BACK_OFFS,		// Ships stepped aside to break a wait
+	COUNTER_COUNT
+};
+
+// Sampled values
+enum Gauge
+{
+	QUEUE_LENGTH,		// Ships waiting to enter the Harbor
+	AVAILABLE_DOCKS,	// Docks available for reservation
+	SHIPS_ON_SURFACE,	// Ships inside the Harbor
+	STALLED_CYCLES,		// Cycles in a row without docking (livelock)
+	GAUGE_COUNT
+};
+
+// Distributions
+enum Histogram
+{
+	CYCLE_MOVES,		// Moves applied per cycle
+	HISTOGRAM_COUNT
+};
+
+// Histogram buckets upper bounds (1-2-5 series, plus +Inf)
+#define HISTOGRAM_BUCKETS 12
+
+
+/*
+ * Simulation metrics registry.
+ *
+ * Counters and histograms are recorded into per-thread blocks (no locking
+ * nor shared cache lines on the hot path) which are only summed when
+ * exported. When enabled (see -m --metrics), metrics are exported every
+ * few cycles to <prefix>.prom (Prometheus text format, rewritten each
+ * time) and <prefix>.csv (one row per export).
+ */
+
+class Metrics
+{
+	private:
+		// Per-thread records (only written by their owner thread)
+		struct Block
+		{
+			std::atomic<uint64_t> counters[COUNTER_COUNT];
+			std::atomic<uint64_t>
+				buckets[HISTOGRAM_COUNT][HISTOGRAM_BUCKETS];
+			std::atomic<double> sums[HISTOGRAM_COUNT];
+		};
+
+		// Current thread's block
+		static thread_local Block * _local;
+		// Every thread's block
+		static std::vector<Block *> _blocks;
+		static std::mutex _blocksMutex;
+
+		// Gauges (last value wins)
+		static std::atomic<double> _gauges[GAUGE_COUNT];
+
+		// Elapsed cycles, cycle of the last CSV row
+		static uint64_t _cycles;
+		static uint64_t _lastRow;
+		static bool _csvHeaderWritten;
+
+		/*** Internal methods ***/
+		static Block & local()
+		{
+			if(_local == nullptr)
+				registerThread();
+			return *_local;
+		}
+		static void registerThread();
+
+		// Single-writer relaxed increment (plain add, no lock prefix)
+		static void add(std::atomic<uint64_t> & a, uint64_t const n)
+		{
+			a.store(a.load(std::memory_order_relaxed) + n,
+				std::memory_order_relaxed);
+		}
+
+		static unsigned bucket(double const value);
+
+		/*** Exporters ***/
+		static void exportPrometheus(std::string const & path);
+		static void exportCSV(std::string const & path);
+
+	public:
+		/*** Recording methods ***/
+		static void increment(Counter const c, uint64_t const n = 1)
+		{
+			add(local().counters[c], n);
+		}
+		static void set(Gauge const g, double const value)
+		{
+			_gauges[g].store(value, std::memory_order_relaxed);
+		}
+		static void observe(Histogram const h, double const value);
+
+		/*** Aggregated values ***/
+		static uint64_t counter(Counter const c);
+		static double gauge(Gauge const g);
+
+		// End of a Tower cycle (exports periodically)
+		static void cycle();
+		// Export now (if enabled)
+		static void flush();
+		// Free the per-thread blocks (end of program)
+		static void clean();
+};
+
+#endif // METRICS_HPP_INCLUDED
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2016 Julien "Derjik" Laurent <julien.laurent@engineer.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef PERFCOUNTERS_HPP_INCLUDED
+#define PERFCOUNTERS_HPP_INCLUDED
+
+#include <cstdint>	// uint64_t
+#include <ostream>	// std::ostream
+#include <string>	// std::string
+#include "Profiler.hpp"	// Phase, PerfCounter
+
+
+/*
+ * Hardware performance counters, read per cycle phase.
+ *
+ * The counters are opened as a single group (so that they are scheduled
+ * together on the PMU) by the process itself, user space only. When they
+ * can't be opened (no PMU, forbidden by perf_event_paranoid, other OS...),
+ * everything silently turns into no-ops and the report says why.
+ */
+
+class PerfCounters
+{
+	private:
+		static bool _available;
+		// Reason why the counters are unavailable
+		static std::string _error;
+
+		// Accumulated counts per phase
+		static uint64_t _totals[PHASE_COUNT][PERF_COUNTER_COUNT];
+
+	public:
+		// Open the counters group (returns false if not permitted)
+		static bool open();
+		static void close();
+
+		static bool available()
+		{
+			return _available;
+		}
+
+		// Read the current value of every counter
+		static void read(uint64_t values[PERF_COUNTER_COUNT]);
+
+		// Accumulate the counts elapsed during one phase
+		static void add(Phase const p,
+				uint64_t const start[PERF_COUNTER_COUNT],
+				uint64_t const end[PERF_COUNTER_COUNT]);
+
+		// Print IPC, cache misses and branch misses per phase
+		static void report(std::ostream & out,
+				uint64_t const calls[PHASE_COUNT]);
+};
+
+#endif // PERFCOUNTERS_HPP_INCLUDED
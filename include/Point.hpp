@@ -54,6 +54,11 @@ class Point
 		{}
 		explicit Point(Direction const d);
 		Point(Point const & p) : _x(p._x), _y(p._y) { }
+		Point & operator = (Point const & p) = default;
+
+		/*** Coordinates ***/
+		int x() const { return _x; }
+		int y() const { return _y; }
 
 		/*** Relational operators ***/
 		bool operator < (Point const & p) const
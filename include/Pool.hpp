@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2016 Julien "Derjik" Laurent <julien.laurent@engineer.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef POOL_HPP_INCLUDED
+#define POOL_HPP_INCLUDED
+
+#include <cstddef>	// std::size_t
+#include <new>		// operator new, operator delete
+
+
+/*
+ * Node recycling allocator for the node-based containers (std::map,
+ * std::set, std::list) whose elements come and go every cycle.
+ *
+ * Single-element blocks are kept in a per-thread, per-type free list when
+ * released and handed back on the next allocation: once a container has
+ * reached its peak size, inserting and erasing no longer touch the heap.
+ * Larger requests go straight to operator new. Released blocks are only
+ * freed at thread exit.
+ */
+
+template <typename T> class PoolAllocator
+{
+	private:
+		// Free block (overlaid on the released T)
+		union Block
+		{
+			Block * next;
+			alignas(T) char storage[sizeof(T)];
+		};
+
+		// Per-thread free list, emptied at thread exit
+		struct FreeList
+		{
+			Block * head;
+
+			FreeList() : head(nullptr) {}
+			~FreeList()
+			{
+				while(head != nullptr)
+				{
+					Block * b(head);
+					head = head->next;
+					::operator delete(b);
+				}
+			}
+		};
+
+		static FreeList & freeList()
+		{
+			static thread_local FreeList list;
+			return list;
+		}
+
+	public:
+		typedef T value_type;
+
+		PoolAllocator() {}
+		template <typename U> PoolAllocator(PoolAllocator<U> const &) {}
+
+		T * allocate(std::size_t const n)
+		{
+			FreeList & list(freeList());
+
+			if(n != 1)
+				return static_cast<T *>(
+					::operator new(n * sizeof(T)));
+
+			if(list.head == nullptr)
+				return reinterpret_cast<T *>(
+					::operator new(sizeof(Block)));
+
+			Block * b(list.head);
+			list.head = b->next;
+			return reinterpret_cast<T *>(b);
+		}
+
+		void deallocate(T * p, std::size_t const n)
+		{
+			FreeList & list(freeList());
+
+			if(n != 1)
+			{
+				::operator delete(p);
+				return;
+			}
+
+			Block * b(reinterpret_cast<Block *>(p));
+			b->next = list.head;
+			list.head = b;
+		}
+
+		// Stateless: any instance can release any other's blocks
+		template <typename U>
+		bool operator == (PoolAllocator<U> const &) const
+		{
+			return true;
+		}
+		template <typename U>
+		bool operator != (PoolAllocator<U> const &) const
+		{
+			return false;
+		}
+};
+
+// Stock the pool with one node per element of the given container, ready
+// for a later refill while its current nodes are still in use (the node
+// type is private to the container: copying it allocates the nodes, and
+// destroying the copy hands them over to the free list)
+template <typename Container> void reserveNodes(Container const & c)
+{
+	Container const copy(c);
+}
+
+#endif // POOL_HPP_INCLUDED
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2016 Julien "Derjik" Laurent <julien.laurent@engineer.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef PREEMPTIONINDEX_HPP_INCLUDED
+#define PREEMPTIONINDEX_HPP_INCLUDED
+
+#include <map>		// std::map
+#include <set>		// std::set
+#include <typeindex>	// std::type_index
+#include <vector>	// std::vector
+
+#include "Pool.hpp"	// PoolAllocator
+
+
+// Mandatory forward-declarations
+class Ship;
+
+
+/*
+ * Index of the dock reservation holders, used to find which Ship to evict
+ * when a higher priority one finds no available dock.
+ *
+ * Ship::accept() only depends on the Ship's class and the dock ID, so the
+ * docks each class accepts are computed once (the first time a Ship of
+ * that class asks for an eviction). For each such class, the reserved
+ * docks it accepts are then kept in one ordered set per holder priority:
+ * the best candidate (lowest priority holder, then lowest dock ID) is the
+ * first element of the first non-empty set below the requester's priority.
+ * Reservations cost O(log n) per known class to index.
+ */
+
+class PreemptionIndex
+{
+	private:
+		typedef std::set<unsigned, std::less<unsigned>,
+				PoolAllocator<unsigned>> Docks;
+
+		// What one Ship class sees of the reservations
+		struct View
+		{
+			// Accepted docks (by dock ID)
+			std::vector<bool> accepts;
+			// Accepted reserved docks, by holder priority
+			std::map<unsigned, Docks> byPriority;
+		};
+
+		// Reservation holder of each dock (by dock ID)
+		std::vector<Ship const *> _holders;
+
+		std::map<std::type_index, View> _views;
+
+		View & view(Ship const * const s);
+
+	public:
+		// Index the reservations of docks 1 to docks
+		PreemptionIndex(unsigned const docks);
+
+		// Dock reservation / release
+		void insert(unsigned const dockId, Ship const * const s);
+		void erase(unsigned const dockId);
+
+		// Holder of the best dock to take over for the given Ship
+		// (nullptr if no lower priority Ship holds a dock it accepts)
+		Ship const * candidate(Ship const * const s);
+};
+
+#endif // PREEMPTIONINDEX_HPP_INCLUDED
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2016 Julien "Derjik" Laurent <julien.laurent@engineer.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef PROFILER_HPP_INCLUDED
+#define PROFILER_HPP_INCLUDED
+
+#include <cstdint>	// uint64_t
+#include <ostream>	// std::ostream
+
+
+// Timed phases of a Tower cycle
+enum Phase
+{
+	PLAN,		// Route planning (planMovements, planEvacuation)
+	DISPLAY,	// Renderer frame
+	APPLY,		// applyPlannedMovements
+	NEW_SHIPS,	// manageNewShips
+	ASSIGN,		// batchAssignDocks
+	CLEAN_EXIT,	// cleanExit
+	SLEEP,		// Temporization
+	CYCLE,		// Whole cycle iteration
+	PHASE_COUNT
+};
+
+// Hardware counters read around each phase (see PerfCounters.hpp)
+enum PerfCounter
+{
+	CPU_CYCLES,	// Group leader
+	INSTRUCTIONS,
+	CACHE_MISSES,
+	BRANCH_MISSES,
+	PERF_COUNTER_COUNT
+};
+
+// Log-linear histogram resolution: each power of two is split into
+// 2^PROFILER_SUB_BITS buckets (worst relative error 1/16)
+#define PROFILER_SUB_BITS 4
+#define PROFILER_BUCKETS ((64 - PROFILER_SUB_BITS + 1) << PROFILER_SUB_BITS)
+
+// Calls of a phase after which its containers are deemed grown (zero
+// allocation check)
+#define PROFILER_WARMUP 20
+
+
+/*
+ * Cycle phase profiler.
+ *
+ * Phases are timed with the steady clock through ProfileScope objects and
+ * recorded into fixed-size log-linear histograms (no allocation nor sort
+ * while running). When enabled (see -p --profile), an end-of-run table
+ * reports the p50, p99 and max duration of each phase, along with its
+ * heap allocations and hardware counters (see PerfCounters.hpp).
+ */
+
+class Profiler
+{
+	private:
+		// Durations histograms (nanoseconds)
+		static uint64_t _buckets[PHASE_COUNT][PROFILER_BUCKETS];
+		static uint64_t _count[PHASE_COUNT];
+		static uint64_t _total[PHASE_COUNT];
+		static uint64_t _max[PHASE_COUNT];
+
+		// Heap allocations (and bytes) per phase
+		static uint64_t _allocations[PHASE_COUNT];
+		static uint64_t _allocatedBytes[PHASE_COUNT];
+		// Allocating calls after warm-up (zero allocation check)
+		static uint64_t _allocatingCalls[PHASE_COUNT];
+
+		/*** Histogram helpers ***/
+		static unsigned bucket(uint64_t const ns);
+		static uint64_t bucketUpperBound(unsigned const b);
+		static uint64_t percentile(Phase const p, double const q);
+
+	public:
+		// Record one call of the given phase
+		static void record(Phase const p, uint64_t const ns,
+				uint64_t const allocations,
+				uint64_t const bytes);
+
+		// Phases which must not allocate once warmed up (Ship
+		// creation is the only one allowed to)
+		static bool steadyState(Phase const p)
+		{
+			return p != NEW_SHIPS && p != CYCLE;
+		}
+
+		// Print the allocating phases and return false if any
+		static bool checkAllocations(std::ostream & out);
+
+		// Print the end-of-run table (if enabled)
+		static void report(std::ostream & out);
+
+		static char const * name(Phase const p);
+};
+
+
+/*
+ * Scoped phase timer: times its own lifetime (does nothing when neither
+ * profiling nor tracing are enabled). Also traces the phase as a span and
+ * reads the hardware counters (when available) and the heap allocation
+ * counters.
+ */
+
+class ProfileScope
+{
+	private:
+		Phase const _phase;
+		bool const _enabled;
+		uint64_t _start;
+		uint64_t _counters[PERF_COUNTER_COUNT];
+		uint64_t _allocations;
+		uint64_t _bytes;
+
+	public:
+		ProfileScope(Phase const p);
+		~ProfileScope();
+};
+
+#endif // PROFILER_HPP_INCLUDED
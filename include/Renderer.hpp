@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2016 Julien "Derjik" Laurent <julien.laurent@engineer.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef RENDERER_HPP_INCLUDED
+#define RENDERER_HPP_INCLUDED
+
+#include <string>	// std::string
+#include <vector>	// std::vector
+
+
+// Mandatory forward-declarations
+class Harbor;
+class Ship;
+class ShipQueue;
+
+
+/*
+ * Draws the waiting queue and the Harbor's surface on the terminal.
+ *
+ * Frames have the size of the screen rather than the size of the Harbor:
+ * when the Harbor doesn't fit, a viewport is displayed instead. It can be
+ * scrolled (arrows or h/j/k/l), follow a moving Ship (f) and zoom out
+ * (+/-), each symbol then standing for the Ship density of a whole block
+ * of cells. Block densities are updated from the Harbor's changed cells
+ * rather than recomputed.
+ *
+ * On a terminal, only the symbols that changed since the previous frame
+ * are redrawn (using cursor addressing), the whole frame being sent with
+ * a single write. Otherwise (e.g. output redirected to a file), full
+ * frames are appended one after the other.
+ */
+
+class Renderer
+{
+	private:
+		// Displayed Harbor
+		Harbor const * _harbor;
+
+		/*** View settings ***/
+		// Displayed symbols (columns x rows)
+		unsigned _columns;
+		unsigned _rows;
+		// Harbor cells per symbol side
+		unsigned _zoom;
+		// Harbor cell displayed in the top left corner
+		int _originX;
+		int _originY;
+		// Whole Harbor displayed without zoom (classic layout)
+		bool _fullView;
+		// Followed Ship (if any)
+		bool _follow;
+		Ship const * _followed;
+
+		/*** Static layout ***/
+		// Symbol of every Harbor cell but its Ship (water, entry point
+		// or dock), row by row
+		std::vector<unsigned> _layout;
+
+		/*** Block densities (maintained while zoomed out) ***/
+		std::vector<bool> _occupied;
+		std::vector<unsigned> _blockShips;
+		// Zoom the densities were computed for (0 if none)
+		unsigned _blockZoom;
+
+		/*** Frames ***/
+		// Symbols (see Renderer_<OS>.cpp for the encoding)
+		std::vector<unsigned> _frame;
+		std::vector<unsigned> _previousFrame;
+		// Ships drawn on the current frame's symbols
+		std::vector<Ship const *> _ships;
+
+		// Queue and status lines of the current and previous frames
+		std::string _queueLine;
+		std::string _previousQueueLine;
+		std::string _statusLine;
+		std::string _previousStatusLine;
+
+		// Output buffer (sent once per frame)
+		std::string _buffer;
+
+		// Whether symbols are redrawn in place
+		bool _inPlace;
+		// Whether keys are read from the terminal
+		bool _interactive;
+		// Whether the next frame has to be entirely drawn
+		bool _firstFrame;
+
+		/*** View management methods ***/
+		void readKeys();
+		void updateView();
+		void updateDensities();
+
+		/*** Frame building methods ***/
+		void buildQueueLine(ShipQueue const * queue);
+		void buildStatusLine();
+		void buildFrame();
+		void appendSymbol(unsigned const column, unsigned const row);
+		void appendFullFrame();
+		void appendChangedSymbols();
+		void flush();
+
+	public:
+		/*** Constructors & destructors ***/
+		Renderer(Harbor const * h);
+		~Renderer();
+
+		// Draw the (optional) waiting queue and the Harbor's surface
+		void display(ShipQueue const * queue = nullptr);
+};
+
+#endif // RENDERER_HPP_INCLUDED
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2016 Julien "Derjik" Laurent <julien.laurent@engineer.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef ROUTE_HPP_INCLUDED
+#define ROUTE_HPP_INCLUDED
+
+#include "Point.hpp"	// Point, Direction
+
+
+// Mandatory forward-declarations
+class Harbor;
+class Ship;
+class ClusterMap;
+
+
+/*
+ * Common interface for the route searches of the routing strategies (see
+ * Flags::routing): one search leads one Ship to its destination, then is
+ * kept aside for the next Ship.
+ */
+
+class Route
+{
+	public:
+		// Destructor
+		virtual ~Route() {}
+
+		// Start a new search for the given Ship heading to goal
+		virtual void reset(Ship const * const s, Point const & goal) = 0;
+		// The given cell's occupation changed
+		virtual void update(Point const & cell) = 0;
+		// Move the search's start (the Ship's position)
+		virtual void plan(Point const & start) = 0;
+
+		// Next cell on the way to the goal from the given cell (the
+		// preferred direction wins ties), from itself if unreachable
+		virtual Point next(Point const & from,
+				Direction const preferred) = 0;
+
+		virtual Point goal() const = 0;
+
+		// Build a search of the strategy selected by the Flags (the
+		// hierarchical ones share the given ClusterMap)
+		static Route * create(Harbor const * const h,
+					ClusterMap * const clusters);
+};
+
+#endif // ROUTE_HPP_INCLUDED
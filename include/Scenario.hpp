@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2016 Julien "Derjik" Laurent <julien.laurent@engineer.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef SCENARIO_HPP_INCLUDED
+#define SCENARIO_HPP_INCLUDED
+
+#include <cstdint>	// int64_t, uint64_t
+#include <fstream>	// std::ifstream, std::ofstream
+
+
+/*
+ * Scenario recorder / player.
+ *
+ * When recording (see --record), every draw returned by the Die is appended
+ * to a compact binary file, along with a hash of the Harbor's state at the
+ * end of each cycle. When replaying (see --replay), the Die returns the
+ * recorded draws instead of rolling, and each cycle's state hash is checked
+ * against the recorded one, so that two builds run the exact same workload
+ * and any behavioural drift is caught at the cycle it appears.
+ *
+ * File layout: the "HBSC" magic, a version byte, then one record per draw
+ * or checkpoint. Integers are stored as zigzag varints whose two low bits
+ * give the record kind; floats and hashes follow their kind as raw bytes.
+ */
+
+class Scenario
+{
+	private:
+		// Record kinds
+		enum Kind
+		{
+			INTEGER = 0,
+			REAL = 1,
+			CHECKPOINT = 2
+		};
+
+		static std::ofstream _record;
+		static std::ifstream _replay;
+
+		// Checkpoints written or checked so far
+		static uint64_t _checkpoints;
+		// Indicates wether the replay diverged (then draws are live)
+		static bool _drifted;
+
+		static void writeVarint(uint64_t v);
+		static bool readVarint(uint64_t & v);
+
+		// Report the first divergence and stop replaying
+		static void drift(char const * what);
+
+	public:
+		// Open the record or replay file given by the Flags
+		static void open();
+		// Report the replay's outcome and close the file
+		static void close();
+
+		static bool recording() { return _record.is_open(); }
+		static bool replaying() { return _replay.is_open(); }
+		static bool active() { return recording() || replaying(); }
+		static bool drifted() { return _drifted; }
+
+		// Get the next recorded draw (false if not replaying, or once
+		// the replay diverged: the draw must then be rolled)
+		static bool next(int64_t & value);
+		static bool next(float & value);
+
+		// Same, for a draw expected within [min, max] (a recorded value
+		// out of it means the replay diverged)
+		static bool next(int64_t & value, int64_t const min,
+					int64_t const max);
+		static bool next(float & value, float const min,
+					float const max);
+
+		// Record a rolled draw (if recording)
+		static void record(int64_t const value);
+		static void record(float const value);
+
+		// Record or check the state hash of the cycle that just ended
+		static void checkpoint(uint64_t const hash);
+};
+
+#endif // SCENARIO_HPP_INCLUDED
@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2016 Julien "Derjik" Laurent <julien.laurent@engineer.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef SCHEDULEDARRIVALS_HPP_INCLUDED
+#define SCHEDULEDARRIVALS_HPP_INCLUDED
+
+#include <vector>	// std::vector
+#include "ArrivalProcess.hpp"	// ArrivalProcess
+
+
+/*
+ * Scheduled arrivals (fixed numbers of Ships per cycle, the schedule
+ * starting over once exhausted)
+ */
+
+class ScheduledArrivals : public ArrivalProcess
+{
+	private:
+		std::vector<unsigned> const _schedule;
+
+		// Next cycle's index in the schedule
+		unsigned _next;
+
+	public:
+		ScheduledArrivals(std::vector<unsigned> const & schedule)
+			: _schedule(schedule), _next(0) {}
+
+		unsigned arrivals();
+};
+
+#endif // SCHEDULEDARRIVALS_HPP_INCLUDED
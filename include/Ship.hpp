@@ -34,6 +34,18 @@ class Hull;
 class Factory;
 
 
+// Lifecycle of a Ship, as tracked by the Tower
+enum ShipState
+{
+	ENTERING,	// Built, waiting for or given an entry point
+	ROUTING,	// Travelling to its dock
+	BLOCKED,	// Stopped by a stronger Ship (until a neighbour changes)
+	DOCKED,		// On its reserved dock
+	LEAVING,	// Heading to an exit
+	STATE_COUNT
+};
+
+
 /*
  * Common interface for all Ships.
  */
@@ -43,11 +55,23 @@ class Ship : public Visited
 	private:
 		// The Ship's name
 		std::string _name;
+		// Serial number of the last Ship built (default names)
+		static unsigned long _serial;
 
 		/*** Ship components ***/
 		Engine* _engine;
 		Hull* _hull;
 
+		// Engine steps left before the next failure (drawn lazily
+		// since failureProbability() isn't available at construction)
+		mutable unsigned _stepsBeforeFailure;
+		mutable bool _failureRolled;
+
+		// Lifecycle state (set by the Tower) and number of living
+		// Ships in each state
+		mutable ShipState _state;
+		static unsigned _census[STATE_COUNT];
+
 	protected:
 		// Color to use while displaying on Linux systems
 		unsigned _LinuxColor;
@@ -67,6 +91,15 @@ class Ship : public Visited
 		unsigned speed() const;
 		Hull const * hull() const;
 
+		// Engine failure trial for a single step
+		bool engineFails() const;
+
+		/*** Lifecycle-related methods ***/
+		ShipState state() const;
+		void setState(ShipState const s) const;
+		// Number of living Ships in the given state
+		static unsigned count(ShipState const s);
+
 		/*** Interface to implement in subclasses ***/
 		virtual float failureProbability() const = 0;
 		virtual bool accept(unsigned const dockId) const = 0;
@@ -78,6 +111,10 @@ class Ship : public Visited
 
 		/*** Display-related methods ***/
 		void display() const;
+		// Append the Ship's symbol to the given frame buffer
+		void display(std::string & frame) const;
+		// Color used by the current OS
+		unsigned color() const;
 };
 
 #endif // SHIP_HPP_INCLUDED
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2016 Julien "Derjik" Laurent <julien.laurent@engineer.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef SHIPQUEUE_HPP_INCLUDED
+#define SHIPQUEUE_HPP_INCLUDED
+
+#include <cstdint>	// uint64_t
+#include <vector>	// std::vector
+
+
+// Mandatory forward-declarations
+class Ship;
+
+
+/*
+ * Waiting line of the Ships which couldn't enter the Harbor yet, served by
+ * priority with aging: a Ship's effective priority is its own priority
+ * plus "aging" points per cycle spent waiting, so that low priority Ships
+ * are never starved.
+ *
+ * Since every waiting Ship ages at the same pace, comparing two effective
+ * priorities at any cycle amounts to comparing priority - aging * arrival
+ * cycle, which never changes once a Ship is queued: the line is a binary
+ * heap (in a vector) on that key, with O(log n) push and pop. Ties are
+ * broken first come, first served.
+ */
+
+class ShipQueue
+{
+	private:
+		struct Entry
+		{
+			double key;
+			uint64_t order;	// arrival rank (ties)
+			Ship const * ship;
+		};
+
+		// Heap ordering: "a is served after b"
+		static bool after(Entry const & a, Entry const & b)
+		{
+			return a.key < b.key
+				|| (a.key == b.key && a.order > b.order);
+		}
+
+		std::vector<Entry> _heap;
+		double _aging;
+		uint64_t _pushed;
+
+		// Heap indices still to visit by next()
+		std::vector<unsigned> _frontier;
+
+	public:
+		ShipQueue(double const aging) : _aging(aging), _pushed(0) {}
+
+		// Queue a Ship arriving at the given cycle
+		void push(Ship const * const s, uint64_t const cycle);
+		// Remove and return the next Ship to serve (queue not empty)
+		Ship const * pop();
+
+		unsigned size() const { return _heap.size(); }
+		bool empty() const { return _heap.empty(); }
+
+		// Append the (at most) k next Ships to serve to the given
+		// vector, in serving order, without dequeuing them:
+		// O(k log k)
+		void next(unsigned const k, std::vector<Ship const *> & out);
+		// Size next()'s buffer for up to k Ships
+		void reserveNext(unsigned const k)
+		{
+			_frontier.reserve(k + 1);
+		}
+
+		// Waiting Ships, in no particular order (display purposes)
+		Ship const * at(unsigned const i) const
+		{
+			return _heap[i].ship;
+		}
+};
+
+#endif // SHIPQUEUE_HPP_INCLUDED
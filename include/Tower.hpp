@@ -23,17 +23,35 @@
 #ifndef TOWER_HPP_INCLUDED
 #define TOWER_HPP_INCLUDED
 
-#include <list>			// std::list
+#include <cstdint>		// uint64_t
 #include <vector>		// std::vector
 
 #include "Point.hpp"		// Point
 #include "Logger.hpp"		// Logger, custom endl
 #include "XMLVisitor.hpp"	// XMLVisitor
+#include "Renderer.hpp"		// Renderer
+#include "ShipQueue.hpp"	// ShipQueue
+#include "DockMatcher.hpp"	// DockMatcher
+#include "EventQueue.hpp"	// EventQueue
 
 
 // Mandatory forward-declarations
 class Harbor;
 class Ship;
+class ArrivalProcess;
+class Route;
+class ClusterMap;
+
+
+// Ships reassigned at most by one batch dock assignment
+#define DOCK_BATCH_SIZE 64
+
+// Cycles a Ship waits on the same Ship before the wait is broken
+#define WAIT_PATIENCE 8
+
+// Cycles a broken wait is remembered (a cycle forming again within them
+// carries on its age)
+#define WAIT_MEMORY 64
 
 
 /*
@@ -44,51 +62,167 @@ class Ship;
 
 class Tower
 {
+	// Benchmark harness (bench/TowerBench.cpp)
+	friend class TowerBench;
+
 	private:
 		// Logging system
 		Logger _log;
 		XMLVisitor _xml;
 
-		// Tower-managed members
-		std::list<Ship const *> _shipQueue;
-		std::vector<std::pair<Point, Point>> _plannedMovements;
+		// Tower-managed members (planned moves: Ship, source, then
+		// destination)
+		struct Movement
+		{
+			Ship const * ship;
+			Point source;
+			Point destination;
+		};
+		ShipQueue _shipQueue;
+		std::vector<Movement> _plannedMovements;
 
 		// Managed Harbor instance
 		Harbor * _harbor;
 
+		// Ship arrivals of the current cycle() loop
+		ArrivalProcess * _arrivals;
+
+		// Cycles run so far (waiting queue aging)
+		uint64_t _cycle;
+
+		// Batch dock assignment (kept from one batch to the next)
+		DockMatcher _matcher;
+		std::vector<Ship const *> _batchShips;
+		std::vector<Point> _batchOrigins;
+		std::vector<unsigned> _batchDocks;
+		std::vector<Point> _batchDockPositions;
+		std::vector<std::pair<Ship const *, unsigned>> _batchChanges;
+
+		// Ships to plan in the next cycle (see planMovements)
+		std::vector<Ship const *> _active;
+
+		// Route searches of the Ships on their way (sorted by Ship)
+		// and spare ones, one per Ship on the surface at most (see
+		// Route), and the map the hierarchical ones share
+		std::vector<std::pair<Ship const *, Route *>> _routes;
+		std::vector<Route *> _spareRoutes;
+		ClusterMap * _clusters;
+
+		// Evacuation (see planEvacuation): leaving Ships, occupation of
+		// the cells (flattened) and first cycle each exit is free of
+		// the Ships sent there
+		struct Evacuee
+		{
+			Ship const * ship;
+			Point position;
+			Point exit;
+			unsigned distance;	// To the nearest exit
+			unsigned rank;		// Chosen exit's rank
+		};
+		std::vector<Evacuee> _evacuees;
+		std::vector<bool> _occupied;
+		std::vector<unsigned> _exitLoads;
+
+		// Wait-for graph (see resolveWaits): Ships kept from moving by
+		// another one during the cycle, then their waits sorted by
+		// position (and those of the previous cycle), the waits of the
+		// cycles broken lately, the Ships of a wait cycle and the Ships
+		// stepping aside (see backOff)
+		struct Wait
+		{
+			Ship const * ship;
+			Ship const * blocker;
+			Point position;
+			Point next;		// Blocker's position
+			unsigned cycles;	// Spent waiting on the blocker
+			unsigned mark;		// Cycle detection walk
+			uint64_t broken;	// Cycle of the last break (or 0)
+		};
+		std::vector<std::pair<Ship const *, Ship const *>> _blockers;
+		std::vector<Wait> _waits;
+		std::vector<Wait> _lastWaits;
+		std::vector<Wait> _brokenWaits;
+		std::vector<unsigned> _ring;
+		std::vector<std::pair<Ship const *, Point>> _backOffs;
+		std::vector<std::pair<Ship const *, unsigned>> _swaps;
+
+		// Livelock watchdog (see watch): Ships docked during the
+		// cycle, cycles in a row without any and whether it gave up
+		unsigned _dockings;
+		unsigned _stalledCycles;
+		bool _livelocked;
+
+		// Event-driven loop (see runEvents) and its Ships due to move
+		EventQueue _events;
+		std::vector<Ship const *> _due;
+
+		// Terminal display
+		Renderer _renderer;
+
 	protected:
 		/*** Internal management methods ***/
-		bool traceRoute(Point const & source, Point const & dest);
+		bool traceRoute(Point const & source, Point const & dest,
+				bool * const blocked = nullptr);
+		Direction steer(Point const & from, Point const & dest) const;
 		bool planMovements();
+		bool planMovement(Point const & source, Ship const * const s);
+
+		void activate(Ship const * const s);
+		void wakeShips();
+		void prepare(std::vector<Ship const *> & ships);
+
+		Route * route(Ship const * const s, Point const & dest);
+		void reserveRoutes();
+		void releaseRoutes();
+		void repairRoutes();
 
 		void applyPlannedMovements();
 
+		void wait(Ship const * const s, Ship const * const blocker);
+		void resolveWaits();
+		void breakCycle(unsigned const first);
+		void rememberCycle();
+		void forgetCycle();
+		bool squatted(Wait const & w) const;
+		bool backOff(Ship const * const s, Point const & blocker);
+		bool redock(Wait const & w);
+		bool watch(bool const progress);
+
 		bool replaceReservation(Ship const * const original,
 					Ship const * const replacement);
 		bool assignDock(Ship const * const s);
+		void batchAssignDocks();
 		void insertShip(Ship const * const s);
-		void manageNewShips(unsigned const proba);
+		void manageNewShips(unsigned arrivals);
+
+		void runEvents();
+		void scheduleShip(Ship const * const s);
+		bool scheduleArrival();
 
 		Point chooseExit(Point const & source);
 		void cleanExit();
-		void manageOutgoingShip(Ship const * ship);
+		void planEvacuation();
+		void stepOut(Evacuee & e);
+
+		void sampleMetrics();
 
 		void sleep(unsigned const milliseconds);
 
 		// Ship creator
 		Ship const * createShip();
 
-		// Queue display
-		void displayQueue();
-
 	public:
 		// Constructors & destructors
 		Tower(Harbor * h);
+		~Tower();
 
 
 		// Main management loop
 		void cycle(unsigned const proba=50);
 		void cycleOut();
+
+		// Whether the watchdog ended a loop (see --watchdog)
+		bool livelocked() const;
 };
 
 #endif // TOWER_HPP_INCLUDED
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2016 Julien "Derjik" Laurent <julien.laurent@engineer.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef TRACER_HPP_INCLUDED
+#define TRACER_HPP_INCLUDED
+
+#include <chrono>	// std::chrono::steady_clock
+#include <cstdint>	// uint64_t
+#include <mutex>	// std::mutex
+#include <string>	// std::string
+#include <vector>	// std::vector
+
+
+/*
+ * Timeline tracer.
+ *
+ * When enabled (see -t --trace), completed spans are appended to per-thread
+ * in-memory buffers and written at exit as a Chrome trace-event JSON file
+ * (loadable in chrome://tracing or ui.perfetto.dev). Span names and
+ * categories must be string literals: only their address is kept.
+ */
+
+class Tracer
+{
+	private:
+		// Completed span ("X" event)
+		struct Event
+		{
+			char const * name;
+			char const * category;
+			uint64_t start;		// ns since the trace origin
+			uint64_t duration;	// ns
+			char const * argName;	// optional argument
+			std::string argValue;
+		};
+
+		// Per-thread buffer
+		struct Buffer
+		{
+			unsigned tid;
+			std::vector<Event> events;
+		};
+
+		// Current thread's buffer
+		static thread_local Buffer * _local;
+		// Every thread's buffer
+		static std::vector<Buffer *> _buffers;
+		static std::mutex _buffersMutex;
+
+		// Time origin of the trace
+		static std::chrono::steady_clock::time_point const _origin;
+
+		static Buffer & local();
+
+		static void writeEscaped(std::ostream & out,
+					std::string const & s);
+
+	public:
+		// Nanoseconds elapsed since the trace origin
+		static uint64_t now();
+
+		// Record a completed span
+		static void complete(char const * name, char const * category,
+				uint64_t const start, uint64_t const end,
+				char const * argName = nullptr,
+				std::string const & argValue = "");
+
+		// Write the trace file (if enabled) and free the buffers
+		static void flush();
+};
+
+
+/*
+ * Scoped span: traces its own lifetime (does nothing when tracing is
+ * disabled).
+ */
+
+class TraceScope
+{
+	private:
+		char const * const _name;
+		char const * const _category;
+		bool const _enabled;
+		uint64_t _start;
+		char const * _argName;
+		std::string _argValue;
+
+	public:
+		TraceScope(char const * name, char const * category);
+		~TraceScope();
+
+		bool enabled() const { return _enabled; }
+
+		// Attach an argument to the span (check enabled() first to
+		// avoid building the value for nothing)
+		void arg(char const * name, std::string const & value)
+		{
+			_argName = name;
+			_argValue = value;
+		}
+};
+
+#endif // TRACER_HPP_INCLUDED
@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2016 Julien "Derjik" Laurent <julien.laurent@engineer.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "../include/Allocations.hpp"
+
+#include <cstdlib>	// malloc(), free()
+#include <new>		// std::bad_alloc, std::nothrow_t, std::align_val_t
+#ifdef _WIN32
+#include <malloc.h>	// _aligned_malloc(), _aligned_free()
+#endif
+
+using namespace std;
+
+
+thread_local uint64_t Allocations::_count(0);
+thread_local uint64_t Allocations::_bytes(0);
+
+
+/*
+ * Replacements of the global allocation functions (the array, nothrow and
+ * sized versions forward to these by default, but are replaced as well so
+ * that every allocation goes through the counters, and every deallocation
+ * matches its allocation).
+ */
+
+void * operator new(size_t size)
+{
+	void * p(malloc(size == 0 ? 1 : size));
+
+	if(p == nullptr)
+		throw bad_alloc();
+
+	Allocations::record(size);
+	return p;
+}
+
+void * operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void * operator new(size_t size, nothrow_t const &) noexcept
+{
+	void * p(malloc(size == 0 ? 1 : size));
+
+	if(p != nullptr)
+		Allocations::record(size);
+	return p;
+}
+
+void * operator new[](size_t size, nothrow_t const & n) noexcept
+{
+	return operator new(size, n);
+}
+
+void operator delete(void * p) noexcept
+{
+	free(p);
+}
+
+void operator delete[](void * p) noexcept
+{
+	free(p);
+}
+
+void operator delete(void * p, nothrow_t const &) noexcept
+{
+	free(p);
+}
+
+void operator delete[](void * p, nothrow_t const &) noexcept
+{
+	free(p);
+}
+
+void operator delete(void * p, size_t) noexcept
+{
+	free(p);
+}
+
+void operator delete[](void * p, size_t) noexcept
+{
+	free(p);
+}
+
+
+/*
+ * Over-aligned versions (C++17), which can't share malloc() and free()
+ */
+
+#ifdef __cpp_aligned_new
+
+void * operator new(size_t size, align_val_t const alignment,
+			nothrow_t const &) noexcept
+{
+	size_t const a(static_cast<size_t>(alignment));
+	void * p(nullptr);
+
+	if(size == 0)
+		size = 1;
+#ifdef _WIN32
+	p = _aligned_malloc(size, a);
+#else
+	if(posix_memalign(&p, a < sizeof(void *) ? sizeof(void *) : a, size)
+	!= 0)
+		p = nullptr;
+#endif
+
+	if(p != nullptr)
+		Allocations::record(size);
+	return p;
+}
+
+void * operator new(size_t size, align_val_t const alignment)
+{
+	void * p(operator new(size, alignment, nothrow));
+
+	if(p == nullptr)
+		throw bad_alloc();
+	return p;
+}
+
+void * operator new[](size_t size, align_val_t const alignment)
+{
+	return operator new(size, alignment);
+}
+
+void * operator new[](size_t size, align_val_t const alignment,
+			nothrow_t const & n) noexcept
+{
+	return operator new(size, alignment, n);
+}
+
+void operator delete(void * p, align_val_t) noexcept
+{
+#ifdef _WIN32
+	_aligned_free(p);
+#else
+	free(p);
+#endif
+}
+
+void operator delete[](void * p, align_val_t const alignment) noexcept
+{
+	operator delete(p, alignment);
+}
+
+void operator delete(void * p, align_val_t const alignment,
+			nothrow_t const &) noexcept
+{
+	operator delete(p, alignment);
+}
+
+void operator delete[](void * p, align_val_t const alignment,
+			nothrow_t const &) noexcept
+{
+	operator delete(p, alignment);
+}
+
+void operator delete(void * p, size_t, align_val_t const alignment) noexcept
+{
+	operator delete(p, alignment);
+}
+
+void operator delete[](void * p, size_t, align_val_t const alignment)
+	noexcept
+{
+	operator delete(p, alignment);
+}
+
+#endif // __cpp_aligned_new
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2016 Julien "Derjik" Laurent <julien.laurent@engineer.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "../include/ArrivalProcess.hpp"
+
+#include "../include/BernoulliArrivals.hpp"	// BernoulliArrivals
+#include "../include/PoissonArrivals.hpp"	// PoissonArrivals
+#include "../include/MMPPArrivals.hpp"		// MMPPArrivals
+#include "../include/ScheduledArrivals.hpp"	// ScheduledArrivals
+#include "../include/Flags.hpp"		// Flags
+
+using namespace std;
+
+
+// Parameters were checked while parsing the Flags
+ArrivalProcess * ArrivalProcess::create(unsigned const proba)
+{
+	vector<float> const & p(Flags::arrivalParameters());
+
+	switch(Flags::arrivalModel())
+	{
+		case POISSON:
+			return new PoissonArrivals(p[0]);
+
+		case MMPP:
+			return new MMPPArrivals(p[0], p[1], p[2], p[3]);
+
+		case SCHEDULE:
+			return new ScheduledArrivals(
+				vector<unsigned>(p.begin(), p.end()));
+
+		default:
+		case BERNOULLI:
+			return new BernoulliArrivals(proba);
+	}
+}
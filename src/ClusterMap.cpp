@@ -0,0 +1,337 @@
+/*
+ * Copyright (c) 2016 Julien "Derjik" Laurent <julien.laurent@engineer.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "../include/ClusterMap.hpp"
+
+#include <algorithm>			// std::push_heap, std::pop_heap, std::find
+#include <cstdlib>			// abs()
+#include "../include/Harbor.hpp"	// Harbor
+#include "../include/Metrics.hpp"	// Metrics
+
+using namespace std;
+
+
+ClusterMap::ClusterMap(Harbor const * const h)
+	: _harbor(h), _width(h->width()), _height(h->height()),
+	_columns((_width + CLUSTER_SIZE - 1) / CLUSTER_SIZE),
+	_rows((_height + CLUSTER_SIZE - 1) / CLUSTER_SIZE),
+	_blocked(_width * _height, false), _clusters(_columns * _rows),
+	_search(_blocked, _width, CLUSTER_SIZE * CLUSTER_SIZE),
+	_g(_width * _height), _parent(_width * _height),
+	_stamp(_width * _height, 0), _generation(0)
+{
+	for(unsigned c = 0 ; c < _clusters.size() ; ++c)
+	{
+		int const x(c % _columns * CLUSTER_SIZE),
+			y(c / _columns * CLUSTER_SIZE);
+
+		_clusters[c].topLeft = Point(x, y);
+		_clusters[c].bottomRight = Point(
+				min(x + CLUSTER_SIZE, _width) - 1,
+				min(y + CLUSTER_SIZE, _height) - 1);
+		_clusters[c].dirty = false;
+		_clusters[c].nodes.reserve(CLUSTER_SIZE);
+		_clusters[c].lengths.reserve(CLUSTER_SIZE * CLUSTER_SIZE);
+	}
+
+	_dirty.reserve(_clusters.size());
+	_heap.reserve(CLUSTER_SIZE * _clusters.size());
+	_toGoal.reserve(4 * CLUSTER_SIZE);
+
+	reset();
+}
+
+// Every cluster gets rebuilt before the next search
+void ClusterMap::reset()
+{
+	fill(_blocked.begin(), _blocked.end(), false);
+	for(auto const & cell : _harbor->surface())
+		_blocked[index(cell.first)] = true;
+
+	for(unsigned c = 0 ; c < _clusters.size() ; ++c)
+		touch(c);
+}
+
+void ClusterMap::update(Point const & cell)
+{
+	static Direction const directions[4] = {UP, DOWN, LEFT, RIGHT};
+	bool const occupied(_harbor->getShipAt(cell) != nullptr);
+	unsigned const c(cluster(cell));
+
+	if(_blocked[index(cell)] == occupied)
+		return;
+
+	_blocked[index(cell)] = occupied;
+	touch(c);
+
+	// The cluster across a border shares the transitions through it
+	for(Direction d : directions)
+	{
+		Point const p(cell + d);
+
+		if(inside(p) && cluster(p) != c)
+			touch(cluster(p));
+	}
+}
+
+bool ClusterMap::find(Point const & start, Point const & goal,
+			vector<Point> & waypoints)
+{
+	static Direction const directions[4] = {UP, DOWN, LEFT, RIGHT};
+	uint64_t expansions(0);
+	uint32_t const origin(index(start));
+	unsigned const first(cluster(start)), last(cluster(goal));
+
+	refresh();
+	waypoints.clear();
+
+	if(start == goal)
+		return true;
+
+	Cluster const & s(_clusters[first]);
+	Cluster const & t(_clusters[last]);
+
+	// Within one cluster, straight away if possible
+	if(first == last && _search.find(start, goal, s.topLeft,
+					s.bottomRight) != UINT32_MAX)
+	{
+		waypoints.push_back(goal);
+		return true;
+	}
+
+	if(++_generation == 0)
+	{
+		fill(_stamp.begin(), _stamp.end(), 0);
+		_generation = 1;
+	}
+	_heap.clear();
+
+	// Link the goal to its cluster's transitions...
+	_toGoal.resize(t.nodes.size());
+	for(unsigned i = 0 ; i < t.nodes.size() ; ++i)
+		_toGoal[i] = _search.find(t.nodes[i], goal, t.topLeft,
+						t.bottomRight);
+
+	// ...and the start (its own parent) to its own
+	_stamp[origin] = _generation;
+	_g[origin] = 0;
+	_parent[origin] = origin;
+	for(Point const & node : s.nodes)
+	{
+		uint32_t const length(_search.find(start, node, s.topLeft,
+							s.bottomRight));
+
+		if(length != UINT32_MAX)
+			reach(node, origin, length, goal);
+	}
+
+	while(!_heap.empty())
+	{
+		pop_heap(_heap.begin(), _heap.end(), after);
+		Entry const e(_heap.back());
+		_heap.pop_back();
+
+		// Stale entry (reached shorter meanwhile)
+		if(e.g > _g[e.cell])
+			continue;
+
+		Point const p(point(e.cell));
+
+		++expansions;
+
+		if(p == goal)
+		{
+			for(uint32_t cell = e.cell ; cell != origin ;
+				cell = _parent[cell])
+				waypoints.push_back(point(cell));
+
+			Metrics::increment(ROUTE_EXPANSIONS, expansions);
+			return true;
+		}
+
+		unsigned const k(cluster(p));
+		Cluster const & c(_clusters[k]);
+		unsigned const r(rank(c, p)), n(c.nodes.size());
+
+		// The cluster's other transitions
+		for(unsigned j = 0 ; j < n ; ++j)
+			if(j != r && c.lengths[r * n + j] != UINT32_MAX)
+				reach(c.nodes[j], e.cell,
+					e.g + c.lengths[r * n + j], goal);
+
+		// The goal
+		if(k == last && _toGoal[r] != UINT32_MAX)
+			reach(goal, e.cell, e.g + _toGoal[r], goal);
+
+		// Across the borders
+		for(Direction d : directions)
+		{
+			Point const q(p + d);
+
+			if(inside(q) && cluster(q) != k
+			&& rank(_clusters[cluster(q)], q)
+				< _clusters[cluster(q)].nodes.size())
+				reach(q, e.cell, e.g + 1, goal);
+		}
+	}
+
+	Metrics::increment(ROUTE_EXPANSIONS, expansions);
+	return false;
+}
+
+bool ClusterMap::refine(Point const & start, Point const & waypoint,
+			vector<Point> & steps)
+{
+	Cluster const & c(_clusters[cluster(start)]);
+
+	steps.clear();
+
+	// Right across a border
+	if(abs(waypoint.x() - start.x()) + abs(waypoint.y() - start.y()) == 1)
+	{
+		steps.push_back(waypoint);
+		return true;
+	}
+
+	if(cluster(waypoint) != cluster(start)
+	|| _search.find(start, waypoint, c.topLeft, c.bottomRight, &steps)
+		== UINT32_MAX)
+		return false;
+
+	reverse(steps.begin(), steps.end());
+	return true;
+}
+
+void ClusterMap::touch(unsigned const c)
+{
+	if(!_clusters[c].dirty)
+	{
+		_clusters[c].dirty = true;
+		_dirty.push_back(c);
+	}
+}
+
+void ClusterMap::refresh()
+{
+	for(unsigned c : _dirty)
+		rebuild(_clusters[c]);
+
+	_dirty.clear();
+}
+
+// Find the cluster's transitions, then the routes between them
+void ClusterMap::rebuild(Cluster & c)
+{
+	Point const & a(c.topLeft);
+	Point const & b(c.bottomRight);
+
+	c.nodes.clear();
+
+	// Top, bottom, left and right borders, if there's a cluster across
+	if(a.y() > 0)
+		transitions(c, a, Point(b.x(), a.y()), Point(0, -1));
+	if(b.y() < _height - 1)
+		transitions(c, Point(a.x(), b.y()), b, Point(0, 1));
+	if(a.x() > 0)
+		transitions(c, a, Point(a.x(), b.y()), Point(-1, 0));
+	if(b.x() < _width - 1)
+		transitions(c, Point(b.x(), a.y()), b, Point(1, 0));
+
+	unsigned const n(c.nodes.size());
+
+	c.lengths.assign(n * n, UINT32_MAX);
+	for(unsigned i = 0 ; i < n ; ++i)
+	{
+		c.lengths[i * n + i] = 0;
+
+		for(unsigned j = i + 1 ; j < n ; ++j)
+			c.lengths[i * n + j] = c.lengths[j * n + i] =
+				_search.find(c.nodes[i], c.nodes[j], a, b);
+	}
+
+	c.dirty = false;
+}
+
+// Transitions along the border from first to last: one per stretch of
+// cells free on both sides (see CLUSTER_WIDE_ENTRANCE). The cluster across
+// scans the same stretches, so that both ends of each transition match.
+void ClusterMap::transitions(Cluster & c, Point const & first,
+				Point const & last, Point const & across)
+{
+	int const dx(first.x() != last.x()), dy(first.y() != last.y());
+	unsigned const length(last.x() - first.x() + last.y() - first.y() + 1);
+	unsigned run(0);
+
+	auto add = [&c](Point const & p)
+	{
+		// (corners lie on two borders)
+		if(std::find(c.nodes.begin(), c.nodes.end(), p) == c.nodes.end())
+			c.nodes.push_back(p);
+	};
+
+	for(unsigned i = 0 ; i <= length ; ++i)
+	{
+		Point const p(first.x() + i * dx, first.y() + i * dy);
+
+		if(i < length && !_blocked[index(p)]
+		&& !_blocked[index(p + across)])
+		{
+			++run;
+			continue;
+		}
+
+		// A stretch ended just before p
+		if(run >= CLUSTER_WIDE_ENTRANCE)
+		{
+			add(Point(p.x() - run * dx, p.y() - run * dy));
+			add(Point(p.x() - dx, p.y() - dy));
+		}
+		else if(run > 0)
+			add(Point(p.x() - (run + 1) / 2 * dx,
+					p.y() - (run + 1) / 2 * dy));
+
+		run = 0;
+	}
+}
+
+// Index of a transition in its cluster (their number if it isn't one)
+unsigned ClusterMap::rank(Cluster const & c, Point const & p) const
+{
+	return std::find(c.nodes.begin(), c.nodes.end(), p) - c.nodes.begin();
+}
+
+void ClusterMap::reach(Point const & p, uint32_t const parent,
+			uint32_t const g, Point const & goal)
+{
+	uint32_t const cell(index(p));
+
+	if(_stamp[cell] == _generation && _g[cell] <= g)
+		return;
+
+	_stamp[cell] = _generation;
+	_g[cell] = g;
+	_parent[cell] = parent;
+
+	_heap.push_back({g + abs(p.x() - goal.x()) + abs(p.y() - goal.y()),
+			g, cell});
+	push_heap(_heap.begin(), _heap.end(), after);
+}
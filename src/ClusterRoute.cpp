@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2016 Julien "Derjik" Laurent <julien.laurent@engineer.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "../include/ClusterRoute.hpp"
+
+#include <cstdlib>			// abs()
+#include "../include/ClusterMap.hpp"	// ClusterMap, CLUSTER_SIZE
+
+using namespace std;
+
+
+ClusterRoute::ClusterRoute(ClusterMap * const map)
+	: _map(map), _ship(nullptr), _lost(true)
+{
+	// (a route rarely crosses more than a row and a column of clusters,
+	// twice as many transitions)
+	_waypoints.reserve(2 * (map->columns() + map->rows()) + 1);
+	_steps.reserve(CLUSTER_SIZE * CLUSTER_SIZE);
+}
+
+void ClusterRoute::reset(Ship const * const s, Point const & goal)
+{
+	_ship = s;
+	_goal = goal;
+	_waypoints.clear();
+	_steps.clear();
+	_lost = true;
+}
+
+void ClusterRoute::plan(Point const & start)
+{
+	advance(start);
+
+	// Search again if the Ship strayed or got stuck behind another one
+	if(_lost || (_waypoints.empty() && start != _goal)
+	|| (!_steps.empty()
+		&& (abs(_steps.back().x() - start.x())
+			+ abs(_steps.back().y() - start.y()) != 1
+		|| _map->blocked(_steps.back()))))
+	{
+		_lost = !_map->find(start, _goal, _waypoints);
+		_steps.clear();
+	}
+}
+
+Point ClusterRoute::next(Point const & from, Direction const)
+{
+	advance(from);
+
+	if(_steps.empty() && !_waypoints.empty()
+	&& !_map->refine(from, _waypoints.back(), _steps))
+		_lost = true;
+
+	if(_lost || _steps.empty()
+	|| abs(_steps.back().x() - from.x())
+		+ abs(_steps.back().y() - from.y()) != 1)
+	{
+		_lost = true;
+		return from;
+	}
+
+	return _steps.back();
+}
+
+// Forget the cells and transitions reached
+void ClusterRoute::advance(Point const & from)
+{
+	for(;;)
+		if(!_steps.empty() && _steps.back() == from)
+			_steps.pop_back();
+		else if(_steps.empty() && !_waypoints.empty()
+			&& _waypoints.back() == from)
+			_waypoints.pop_back();
+		else
+			return;
+}
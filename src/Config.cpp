@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2016 Julien "Derjik" Laurent <julien.laurent@engineer.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "../include/Config.hpp"
+
+#include <fstream>		// std::ifstream
+#include <sstream>		// std::istringstream
+#include <iostream>		// std::cout, std::endl
+
+using namespace std;
+
+AliasTable Config::_factories({1, 1});
+AliasTable Config::_ships({1, 1, 1, 1});
+AliasTable Config::_lowCostEngines({3, 2, 1});
+AliasTable Config::_lowCostHulls({3, 1, 1, 1});
+AliasTable Config::_prestigiousEngines({3, 2, 1});
+AliasTable Config::_prestigiousHulls({3, 1, 1, 1});
+
+
+// Get the table matching the given name
+AliasTable * Config::table(string const & name)
+{
+	if(name == "factories")
+		return &_factories;
+	else if(name == "ships")
+		return &_ships;
+	else if(name == "lowcost.engines")
+		return &_lowCostEngines;
+	else if(name == "lowcost.hulls")
+		return &_lowCostHulls;
+	else if(name == "prestigious.engines")
+		return &_prestigiousEngines;
+	else if(name == "prestigious.hulls")
+		return &_prestigiousHulls;
+	else
+		return nullptr;
+}
+
+/*
+ * Parses the given configuration file, replacing the default tables
+ * with the valid ones it contains (invalid lines are reported and
+ * ignored)
+ */
+void Config::load(string const & path)
+{
+	ifstream file(path);
+	string line, name;
+	unsigned lineNumber(0);
+
+	if(!file)
+	{
+		cout << "Cannot open configuration file \"" << path << "\""
+		<< endl;
+		return;
+	}
+
+	while(getline(file, line))
+	{
+		AliasTable * t(nullptr);
+		vector<float> weights;
+		float w, sum(0.f);
+		bool valid(true);
+
+		++lineNumber;
+
+		// Strip comments and skip blank lines
+		line = line.substr(0, line.find('#'));
+		istringstream s(line);
+		if(!(s >> name))
+			continue;
+
+		while(s >> w)
+		{
+			valid &= (w >= 0.f);
+			sum += w;
+			weights.push_back(w);
+		}
+		// Trailing garbage
+		valid &= s.eof();
+
+		t = table(name);
+		if(t == nullptr)
+		{
+			cout << path << ":" << lineNumber
+			<< ": unknown table \"" << name << "\"" << endl;
+		}
+		else if(!valid || sum <= 0.f || weights.size() != t->size())
+		{
+			cout << path << ":" << lineNumber << ": \"" << name
+			<< "\" expects " << t->size()
+			<< " positive or null weights (default kept)" << endl;
+		}
+		else
+		{
+			*t = AliasTable(weights);
+		}
+	}
+}
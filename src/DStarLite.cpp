@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) 2016 Julien "Derjik" Laurent <julien.laurent@engineer.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "../include/DStarLite.hpp"
+
+#include <algorithm>			// std::push_heap, std::pop_heap, std::min
+#include <cstdlib>			// abs()
+#include "../include/Harbor.hpp"	// Harbor
+#include "../include/Ship.hpp"		// Ship
+#include "../include/Hull.hpp"		// Hull
+#include "../include/Metrics.hpp"	// Metrics
+
+using namespace std;
+
+
+// Unreachable (halved so that sums never wrap around)
+#define DSTAR_INFINITY (UINT32_MAX / 2)
+
+
+DStarLite::DStarLite(Harbor const * const h)
+	: _harbor(h), _ship(nullptr), _width(h->width()), _height(h->height()),
+	_g(_width * _height), _rhs(_width * _height),
+	_stamp(_width * _height, 0), _generation(0),
+	_goal(0), _start(0), _km(0)
+{
+	_heap.reserve(_width * _height);
+}
+
+void DStarLite::reset(Ship const * const s, Point const & goal)
+{
+	_ship = s;
+	_goal = index(goal);
+	_start = _goal;
+	_km = 0;
+	_heap.clear();
+	++_generation;
+
+	touch(_goal);
+	_rhs[_goal] = 0;
+	_heap.push_back(key(_goal));
+}
+
+void DStarLite::update(Point const & cell)
+{
+	uint32_t around[4];
+	unsigned const n(neighbours(index(cell), around));
+
+	// Entering the cell costs something else: its neighbours' lookaheads
+	// may change (unexplored ones can't, their own neighbours being
+	// unexplored as well)
+	for(unsigned i = 0 ; i < n ; ++i)
+		if(_stamp[around[i]] == _generation)
+			updateCell(around[i]);
+}
+
+void DStarLite::plan(Point const & start)
+{
+	uint32_t const cell(index(start));
+
+	// The heuristic moved with the start: shift every key instead of
+	// reordering the heap
+	_km += abs(point(_start).x() - start.x())
+		+ abs(point(_start).y() - start.y());
+	_start = cell;
+
+	computeShortestPath();
+}
+
+Point DStarLite::next(Point const & from, Direction const preferred)
+{
+	uint32_t around[4];
+	uint32_t const cell(index(from)), favourite(index(from + preferred));
+	unsigned const n(neighbours(cell, around));
+	uint32_t best(cell), bestCost(DSTAR_INFINITY), c(0);
+
+	for(unsigned i = 0 ; i < n ; ++i)
+	{
+		c = cost(around[i]) + g(around[i]);
+
+		if(c < bestCost || (c == bestCost && around[i] == favourite))
+		{
+			best = around[i];
+			bestCost = c;
+		}
+	}
+
+	return point(best);
+}
+
+uint32_t DStarLite::g(uint32_t const cell) const
+{
+	return _stamp[cell] == _generation ? _g[cell] : DSTAR_INFINITY;
+}
+
+uint32_t DStarLite::rhs(uint32_t const cell) const
+{
+	return _stamp[cell] == _generation ? _rhs[cell] : DSTAR_INFINITY;
+}
+
+void DStarLite::touch(uint32_t const cell)
+{
+	if(_stamp[cell] != _generation)
+	{
+		_stamp[cell] = _generation;
+		_g[cell] = DSTAR_INFINITY;
+		_rhs[cell] = DSTAR_INFINITY;
+	}
+}
+
+uint32_t DStarLite::cost(uint32_t const cell) const
+{
+	Ship const * const other(_harbor->getShipAt(point(cell)));
+
+	if(other == nullptr || other == _ship
+	|| (*other->hull()) <= (*_ship->hull()))
+		return 1;
+	else
+		return DSTAR_OCCUPIED_COST;
+}
+
+uint32_t DStarLite::heuristic(uint32_t const cell) const
+{
+	return abs(int(cell % _width) - int(_start % _width))
+		+ abs(int(cell / _width) - int(_start / _width));
+}
+
+DStarLite::Entry DStarLite::key(uint32_t const cell) const
+{
+	uint32_t const m(min(g(cell), rhs(cell)));
+
+	return {m + heuristic(cell) + _km, m, cell};
+}
+
+void DStarLite::updateCell(uint32_t const cell)
+{
+	uint32_t around[4];
+
+	touch(cell);
+
+	if(cell != _goal)
+	{
+		unsigned const n(neighbours(cell, around));
+
+		_rhs[cell] = DSTAR_INFINITY;
+		for(unsigned i = 0 ; i < n ; ++i)
+			_rhs[cell] = min(_rhs[cell],
+					cost(around[i]) + g(around[i]));
+	}
+
+	if(_g[cell] != _rhs[cell])
+	{
+		_heap.push_back(key(cell));
+		push_heap(_heap.begin(), _heap.end(), after);
+	}
+}
+
+void DStarLite::computeShortestPath()
+{
+	uint32_t around[4];
+	uint64_t expansions(0);
+
+	while(!_heap.empty())
+	{
+		Entry const top(_heap.front());
+		uint32_t const u(top.cell);
+
+		// Stale entry (the cell got consistent meanwhile)
+		if(g(u) == rhs(u))
+		{
+			pop_heap(_heap.begin(), _heap.end(), after);
+			_heap.pop_back();
+			continue;
+		}
+
+		// The start's distance is settled
+		if(!after(key(_start), top) && rhs(_start) <= g(_start))
+			break;
+
+		pop_heap(_heap.begin(), _heap.end(), after);
+		_heap.pop_back();
+
+		Entry const current(key(u));
+		unsigned const n(neighbours(u, around));
+
+		++expansions;
+
+		// Outdated key: serve it again later
+		if(after(current, top))
+		{
+			_heap.push_back(current);
+			push_heap(_heap.begin(), _heap.end(), after);
+		}
+		// Overconsistent: settle it, then its neighbours
+		else if(_g[u] > _rhs[u])
+		{
+			_g[u] = _rhs[u];
+			for(unsigned i = 0 ; i < n ; ++i)
+				updateCell(around[i]);
+		}
+		// Underconsistent: forget it, then repair around
+		else
+		{
+			_g[u] = DSTAR_INFINITY;
+			updateCell(u);
+			for(unsigned i = 0 ; i < n ; ++i)
+				updateCell(around[i]);
+		}
+	}
+
+	Metrics::increment(ROUTE_EXPANSIONS, expansions);
+}
+
+unsigned DStarLite::neighbours(uint32_t const cell, uint32_t out[4]) const
+{
+	int const x(cell % _width), y(cell / _width);
+	unsigned n(0);
+
+	if(x + 1 < _width)
+		out[n++] = cell + 1;
+	if(x > 0)
+		out[n++] = cell - 1;
+	if(y + 1 < _height)
+		out[n++] = cell + _width;
+	if(y > 0)
+		out[n++] = cell - _width;
+
+	return n;
+}
@@ -23,6 +23,9 @@
 #include "../include/Die.hpp"
 
 #include "../include/Flags.hpp"	// Flags
+#include "../include/Scenario.hpp"	// Scenario
+#include <cstdlib>			// rand()
+#include <limits>			// std::numeric_limits
 
 #ifdef _WIN32			// Windows will need this to seed the RNG
 #include <ctime>		// time()
@@ -33,6 +36,51 @@ using namespace std;
 
 default_random_engine * Die::_rng(nullptr);
 
+// Build the alias table of the given weights (Vose's method)
+AliasTable::AliasTable(vector<float> const & weights)
+	: _probability(weights.size(), 1.f), _alias(weights.size())
+{
+	unsigned const n(weights.size());
+	float sum(0.f);
+	vector<float> scaled(weights);
+	vector<unsigned> small, large;
+
+	for(auto w : weights)
+		sum += w;
+
+	// Scale the weights so that their mean is 1, then sort the columns
+	// depending on which side of the mean they stand
+	for(unsigned i = 0 ; i < n ; ++i)
+	{
+		_alias[i] = i;
+		scaled[i] = scaled[i] * n / sum;
+
+		if(scaled[i] < 1.f)
+			small.push_back(i);
+		else
+			large.push_back(i);
+	}
+
+	// Fill each small column with the excess of a large one
+	while(!small.empty() && !large.empty())
+	{
+		unsigned s(small.back()), l(large.back());
+		small.pop_back();
+
+		_probability[s] = scaled[s];
+		_alias[s] = l;
+
+		scaled[l] = (scaled[l] + scaled[s]) - 1.f;
+		if(scaled[l] < 1.f)
+		{
+			large.pop_back();
+			small.push_back(l);
+		}
+	}
+	// Leftovers (rounding errors aside) are full columns: they keep
+	// their default 1.f probability
+}
+
 // Initialize the RNG engine
 void Die::init()
 {
@@ -67,21 +115,128 @@ void Die::clean()
 // Get a random int
 int Die::roll(int const min, int const max)
 {
+	int64_t recorded(0);
+
+	if(Scenario::next(recorded, min, max))
+		return recorded;
+
 	// Auto init
 	if(_rng == nullptr)
 		init();
 
 	uniform_int_distribution<int> d(min, max);
-	return d(*_rng);
+	int result(d(*_rng));
+
+	Scenario::record(int64_t(result));
+	return result;
 }
 
 // Get a random float
 float Die::roll(float const min, float const max)
 {
+	float recorded(0.f);
+
+	if(Scenario::next(recorded, min, max))
+		return recorded;
+
 	// Auto init
 	if(_rng == nullptr)
 		init();
 
 	uniform_real_distribution<float> d(min, max);
-	return d(*_rng);
+	float result(d(*_rng));
+
+	Scenario::record(result);
+	return result;
+}
+
+// Get a random number of successes before the first failure
+unsigned Die::rollGeometric(float const p)
+{
+	int64_t recorded(0);
+
+	// Degenerate cases (never or always failing)
+	if(p <= 0.f)
+		return numeric_limits<unsigned>::max();
+	if(p >= 1.f)
+		return 0;
+
+	if(Scenario::next(recorded, 0, numeric_limits<unsigned>::max()))
+		return recorded;
+
+	// Auto init
+	if(_rng == nullptr)
+		init();
+
+	geometric_distribution<unsigned> d(p);
+	unsigned result(d(*_rng));
+
+	Scenario::record(int64_t(result));
+	return result;
+}
+
+// Get a random number of events
+unsigned Die::rollPoisson(float const mean)
+{
+	int64_t recorded(0);
+
+	// Degenerate case (nothing ever happens)
+	if(mean <= 0.f)
+		return 0;
+
+	if(Scenario::next(recorded, 0, numeric_limits<unsigned>::max()))
+		return recorded;
+
+	// Auto init
+	if(_rng == nullptr)
+		init();
+
+	poisson_distribution<unsigned> d(mean);
+	unsigned result(d(*_rng));
+
+	Scenario::record(int64_t(result));
+	return result;
+}
+
+// Get a random outcome from the given alias table
+unsigned Die::roll(AliasTable const & t)
+{
+	int64_t recorded(0);
+
+	if(Scenario::next(recorded, 0, int64_t(t.size()) - 1))
+		return recorded;
+
+	// Auto init
+	if(_rng == nullptr)
+		init();
+
+	// A single roll gives both the column (integer part) and the
+	// column's own outcome / alias choice (fractional part)
+	uniform_real_distribution<float> d(0.f, float(t.size()));
+	float x(d(*_rng));
+	unsigned column(x);
+
+	// Guard against float rounding up to t.size()
+	if(column >= t.size())
+		column = t.size() - 1;
+
+	if(x - column >= t.probability(column))
+		column = t.alias(column);
+
+	Scenario::record(int64_t(column));
+	return column;
+}
+
+// Get a random index from the C library's stream (the one main() seeds)
+int Die::rollLegacy(int const n)
+{
+	int64_t recorded(0);
+
+	if(Scenario::next(recorded, 0, n - 1))
+		return recorded;
+
+	int result(rand() % n);
+
+	Scenario::record(int64_t(result));
+	return result;
 }
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2016 Julien "Derjik" Laurent <julien.laurent@engineer.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "../include/DockMatcher.hpp"
+
+#include <limits>		// std::numeric_limits
+
+using namespace std;
+
+
+void DockMatcher::reserve(unsigned const rows, unsigned const columns)
+{
+	_costs.reserve(rows * columns);
+	_assignment.reserve(rows);
+	_u.reserve(rows + 1);
+	_v.reserve(columns + 1);
+	_minv.reserve(columns + 1);
+	_p.reserve(columns + 1);
+	_way.reserve(columns + 1);
+	_used.reserve(columns + 1);
+}
+
+void DockMatcher::reset(unsigned const rows, unsigned const columns)
+{
+	_rows = rows;
+	_columns = columns;
+	_costs.assign(rows * columns, 0);
+	_assignment.assign(rows, 0);
+}
+
+void DockMatcher::solve()
+{
+	long long const infinity(numeric_limits<long long>::max() / 4);
+	unsigned const n(_rows), m(_columns);
+
+	_u.assign(n + 1, 0);
+	_v.assign(m + 1, 0);
+	_p.assign(m + 1, 0);
+	_way.assign(m + 1, 0);
+
+	// Add the rows one by one, each time along the shortest augmenting
+	// path (reduced costs stay non-negative thanks to the potentials)
+	for(unsigned i = 1 ; i <= n ; ++i)
+	{
+		unsigned j0(0), j1(0);
+
+		_p[0] = i;
+		_minv.assign(m + 1, infinity);
+		_used.assign(m + 1, false);
+
+		do
+		{
+			unsigned const i0(_p[j0]);
+			long long delta(infinity);
+
+			_used[j0] = true;
+
+			for(unsigned j = 1 ; j <= m ; ++j)
+				if(!_used[j])
+				{
+					long long const reduced(cost(i0 - 1, j - 1)
+						- _u[i0] - _v[j]);
+
+					if(reduced < _minv[j])
+					{
+						_minv[j] = reduced;
+						_way[j] = j0;
+					}
+					if(_minv[j] < delta)
+					{
+						delta = _minv[j];
+						j1 = j;
+					}
+				}
+
+			for(unsigned j = 0 ; j <= m ; ++j)
+				if(_used[j])
+				{
+					_u[_p[j]] += delta;
+					_v[j] -= delta;
+				}
+				else
+					_minv[j] -= delta;
+
+			j0 = j1;
+		}
+		while(_p[j0] != 0);
+
+		// Flip the augmenting path
+		do
+		{
+			j1 = _way[j0];
+			_p[j0] = _p[j1];
+			j0 = j1;
+		}
+		while(j0 != 0);
+	}
+
+	for(unsigned j = 1 ; j <= m ; ++j)
+		if(_p[j] != 0)
+			_assignment[_p[j] - 1] = j - 1;
+}
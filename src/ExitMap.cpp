@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2016 Julien "Derjik" Laurent <julien.laurent@engineer.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "../include/ExitMap.hpp"
+
+#include <algorithm>	// std::fill
+#include <cstdint>	// UINT32_MAX
+
+using namespace std;
+
+
+ExitMap::ExitMap() : _width(0), _height(0)
+{
+}
+
+// Multi-source breadth-first search: every exit starts at distance 0, and
+// the first exit to reach a cell claims it
+void ExitMap::build(unsigned const width, unsigned const height,
+			set<Point> const & exits)
+{
+	static Direction const directions[4] = {UP, DOWN, LEFT, RIGHT};
+	vector<uint32_t> frontier;
+	size_t head(0);
+
+	_width = width;
+	_height = height;
+	_exits.assign(exits.begin(), exits.end());
+	_nearest.assign(width * height, 0);
+	_distance.assign(width * height, UINT32_MAX);
+
+	frontier.reserve(width * height);
+	for(uint32_t r = 0 ; r < _exits.size() ; ++r)
+		if(inside(_exits[r]) && _distance[index(_exits[r])] != 0)
+		{
+			_nearest[index(_exits[r])] = r;
+			_distance[index(_exits[r])] = 0;
+			frontier.push_back(index(_exits[r]));
+		}
+
+	while(head < frontier.size())
+	{
+		uint32_t const cell(frontier[head++]);
+		Point const p(cell % _width, cell / _width);
+
+		for(Direction d : directions)
+		{
+			Point const q(p + Point(d));
+
+			if(inside(q) && _distance[index(q)] == UINT32_MAX)
+			{
+				_nearest[index(q)] = _nearest[cell];
+				_distance[index(q)] = _distance[cell] + 1;
+				frontier.push_back(index(q));
+			}
+		}
+	}
+}
+
+unsigned ExitMap::downhill(Point const & p, Point out[2]) const
+{
+	uint32_t const cell(index(p));
+	Point const delta(_exits[_nearest[cell]] - p);
+	Direction const first(delta);
+	Direction second(first);
+	unsigned n(0);
+
+	if(_distance[cell] == 0 || _distance[cell] == UINT32_MAX)
+		return 0;
+
+	if((first == LEFT || first == RIGHT) && delta.y() != 0)
+		second = delta.y() > 0 ? DOWN : UP;
+	else if((first == UP || first == DOWN) && delta.x() != 0)
+		second = delta.x() > 0 ? RIGHT : LEFT;
+
+	for(Direction d : {first, second})
+	{
+		Point const q(p + Point(d));
+
+		if(n < 2 && inside(q) && (n == 0 || q != out[0])
+		&& _distance[index(q)] + 1 == _distance[cell])
+			out[n++] = q;
+	}
+
+	return n;
+}
@@ -24,6 +24,7 @@
 
 #include <vector>		// std::vector
 #include <iostream>		// std::cout, std::endl
+#include <cstdio>		// sscanf()
 
 using namespace std;
 
@@ -33,6 +34,30 @@ bool Flags::_randomizeDocks = true;
 bool Flags::_runCycle = false;
 bool Flags::_help = false;
 LogLevel Flags::_logLevel = INFO;
+string Flags::_configFile = "";
+unsigned Flags::_harborWidth = DEFAULT_HARBOR_SIZE;
+unsigned Flags::_harborHeight = DEFAULT_HARBOR_SIZE;
+unsigned Flags::_viewColumns = 0;
+unsigned Flags::_viewRows = 0;
+unsigned Flags::_zoom = 1;
+bool Flags::_follow = false;
+string Flags::_metricsPrefix = "";
+unsigned Flags::_metricsPeriod = DEFAULT_METRICS_PERIOD;
+bool Flags::_profile = false;
+string Flags::_traceFile = "";
+bool Flags::_zeroAllocations = false;
+bool Flags::_headless = false;
+unsigned Flags::_maxCycles = 0;
+string Flags::_recordFile = "";
+string Flags::_replayFile = "";
+ArrivalModel Flags::_arrivalModel = BERNOULLI;
+vector<float> Flags::_arrivalParameters;
+float Flags::_queueAging = DEFAULT_QUEUE_AGING;
+unsigned Flags::_dockBatchPeriod = 0;
+bool Flags::_events = false;
+Routing Flags::_routing = STRAIGHT;
+float Flags::_congestion = 0.f;
+unsigned Flags::_watchdog = DEFAULT_WATCHDOG;
 
 
 /*
@@ -58,6 +83,135 @@ void Flags::parse(int const argc, char const * const argv[])
 			if(i+1 < args.size())
 				parseLogLevel(args[i+1]);
 
+		if(args[i] == "-c" || args[i] == "--config")
+			if(i+1 < args.size())
+				_configFile = args[i+1];
+
+		if(args[i] == "-S" || args[i] == "--size")
+			if(i+1 < args.size()
+			&& !parseDimensions(args[i+1], _harborWidth,
+						_harborHeight, 3))
+			{
+				cout << "Bad Harbor size \"" << args[i+1]
+				<< "\" (<width>x<height> expected, width"
+				<< " at least 3)" << endl;
+				_harborWidth = _harborHeight = DEFAULT_HARBOR_SIZE;
+			}
+
+		if(args[i] == "-V" || args[i] == "--view")
+			if(i+1 < args.size()
+			&& !parseDimensions(args[i+1], _viewColumns, _viewRows,
+						2))
+			{
+				cout << "Bad viewport size \"" << args[i+1]
+				<< "\" (<columns>x<rows> expected)" << endl;
+				_viewColumns = _viewRows = 0;
+			}
+
+		if(args[i] == "-z" || args[i] == "--zoom")
+			if(i+1 < args.size())
+				parseZoom(args[i+1]);
+
+		if(args[i] == "-f" || args[i] == "--follow")
+			_follow = true;
+
+		if(args[i] == "-m" || args[i] == "--metrics")
+			if(i+1 < args.size())
+				_metricsPrefix = args[i+1];
+
+		if(args[i] == "--metrics-period")
+			if(i+1 < args.size()
+			&& !parseUnsigned(args[i+1], _metricsPeriod))
+			{
+				cout << "Bad metrics period \"" << args[i+1]
+				<< "\" (positive or null integer expected)" << endl;
+				_metricsPeriod = DEFAULT_METRICS_PERIOD;
+			}
+
+		if(args[i] == "-p" || args[i] == "--profile")
+			_profile = true;
+
+		if(args[i] == "-t" || args[i] == "--trace")
+			if(i+1 < args.size())
+				_traceFile = args[i+1];
+
+		if(args[i] == "-Z" || args[i] == "--zero-alloc")
+			_zeroAllocations = true;
+
+		if(args[i] == "-H" || args[i] == "--headless")
+			_headless = true;
+
+		if(args[i] == "--max-cycles")
+			if(i+1 < args.size() && !parseUnsigned(args[i+1], _maxCycles))
+			{
+				cout << "Bad cycles limit \"" << args[i+1]
+				<< "\" (positive or null integer expected)" << endl;
+				_maxCycles = 0;
+			}
+
+		if(args[i] == "--record")
+			if(i+1 < args.size())
+				_recordFile = args[i+1];
+
+		if(args[i] == "--replay")
+			if(i+1 < args.size())
+				_replayFile = args[i+1];
+
+		if(args[i] == "-A" || args[i] == "--arrivals")
+			if(i+1 < args.size() && !parseArrivals(args[i+1]))
+			{
+				cout << "Bad arrival process \"" << args[i+1]
+				<< "\" (see --help)" << endl;
+				_arrivalModel = BERNOULLI;
+				_arrivalParameters.clear();
+			}
+
+		if(args[i] == "--aging")
+			if(i+1 < args.size() && (!parseFloat(args[i+1], _queueAging)
+			|| _queueAging < 0.f))
+			{
+				cout << "Bad queue aging \"" << args[i+1]
+				<< "\" (positive or null number expected)" << endl;
+				_queueAging = DEFAULT_QUEUE_AGING;
+			}
+
+		if(args[i] == "--batch-docks")
+			if(i+1 < args.size()
+			&& !parseUnsigned(args[i+1], _dockBatchPeriod))
+			{
+				cout << "Bad batch assignment period \"" << args[i+1]
+				<< "\" (positive or null integer expected)" << endl;
+				_dockBatchPeriod = 0;
+			}
+
+		if(args[i] == "-E" || args[i] == "--events")
+			_events = true;
+
+		if(args[i] == "-R" || args[i] == "--routing")
+			if(i+1 < args.size() && !parseRouting(args[i+1]))
+			{
+				cout << "Bad routing strategy \"" << args[i+1]
+				<< "\" (see --help)" << endl;
+				_routing = STRAIGHT;
+			}
+
+		if(args[i] == "--watchdog")
+			if(i+1 < args.size() && !parseUnsigned(args[i+1], _watchdog))
+			{
+				cout << "Bad watchdog limit \"" << args[i+1]
+				<< "\" (positive or null integer expected)" << endl;
+				_watchdog = DEFAULT_WATCHDOG;
+			}
+
+		if(args[i] == "--congestion")
+			if(i+1 < args.size() && (!parseFloat(args[i+1], _congestion)
+			|| _congestion < 0.f))
+			{
+				cout << "Bad congestion weight \"" << args[i+1]
+				<< "\" (positive or null number expected)" << endl;
+				_congestion = 0.f;
+			}
+
 		if(args[i] == "--ordered-docks" || args[i] == "-o")
 			_randomizeDocks = false;
 
@@ -70,6 +224,10 @@ void Flags::parse(int const argc, char const * const argv[])
 		if(args[i] == "run")
 			_runCycle = true;
 	}
+
+	// Log lines allocate: the zero allocation mode runs without them
+	if(_zeroAllocations)
+		_logLevel = NONE;
 }
 
 // Parse a log level
@@ -85,10 +243,129 @@ void Flags::parseLogLevel(string const & s)
 		l = WARN;
 	else if(s == "ERROR")
 		l = ERROR;
+	else if(s == "NONE")
+		l = NONE;
 
 	_logLevel = l;
 }
 
+// Parse a "<width>x<height>" string (width at least minWidth, height at
+// least 2)
+bool Flags::parseDimensions(string const & s, unsigned & w, unsigned & h,
+				unsigned const minWidth)
+{
+	unsigned width(0), height(0);
+	char trailing;
+
+	if(sscanf(s.c_str(), "%ux%u%c", &width, &height, &trailing) != 2
+	|| width < minWidth || height < 2)
+		return false;
+
+	w = width;
+	h = height;
+	return true;
+}
+
+// Parse a zoom factor
+void Flags::parseZoom(string const & s)
+{
+	unsigned zoom(1);
+	char trailing;
+
+	if(sscanf(s.c_str(), "%u%c", &zoom, &trailing) != 1)
+	{
+		cout << "Bad zoom value \"" << s;
+		cout << "\" (positive or null integer expected)" << endl;
+
+		// Fallback value
+		zoom = 1;
+	}
+
+	_zoom = zoom;
+}
+
+// Parse a "<model>[:<p1>,<p2>,...]" arrival process
+bool Flags::parseArrivals(string const & s)
+{
+	string const model(s.substr(0, s.find(':')));
+	vector<float> parameters;
+	float p(0.f);
+
+	// Comma-separated parameters, if any
+	if(s.find(':') != string::npos)
+	{
+		size_t begin(s.find(':') + 1), end(0);
+
+		do
+		{
+			end = s.find(',', begin);
+			if(!parseFloat(s.substr(begin, end - begin), p)
+			|| p < 0.f)
+				return false;
+
+			parameters.push_back(p);
+			begin = end + 1;
+		}
+		while(end != string::npos);
+	}
+
+	if(model == "bernoulli" && parameters.empty())
+		_arrivalModel = BERNOULLI;
+	else if(model == "poisson" && parameters.size() == 1)
+		_arrivalModel = POISSON;
+	else if(model == "mmpp" && parameters.size() == 4
+	&& parameters[2] <= 1.f && parameters[3] <= 1.f)
+		_arrivalModel = MMPP;
+	else if(model == "schedule" && !parameters.empty())
+		_arrivalModel = SCHEDULE;
+	else
+		return false;
+
+	_arrivalParameters = parameters;
+	return true;
+}
+
+// Parse a route planning strategy
+bool Flags::parseRouting(string const & s)
+{
+	if(s == "straight")
+		_routing = STRAIGHT;
+	else if(s == "dstar")
+		_routing = DSTAR;
+	else if(s == "hpa")
+		_routing = HPA;
+	else
+		return false;
+
+	return true;
+}
+
+// Parse a positive or null integer
+bool Flags::parseUnsigned(string const & s, unsigned & value)
+{
+	unsigned v(0);
+	char trailing;
+
+	if(sscanf(s.c_str(), "%u%c", &v, &trailing) != 1)
+		return false;
+
+	value = v;
+	return true;
+}
+
+// Parse a floating point number
+bool Flags::parseFloat(string const & s, float & value)
+{
+	float v(0.f);
+	char trailing;
+
+	if(sscanf(s.c_str(), "%f%c", &v, &trailing) != 1)
+		return false;
+
+	value = v;
+	return true;
+}
+
 // Print the help message
 void Flags::printHelp()
 {
@@ -109,8 +386,147 @@ void Flags::printHelp()
 	cout << "\t\tSet the delay (in milliseconds) between two" << endl;
 	cout << "\t\tTower cycles" << endl << endl;
 
-	cout << "\t-v --verbosity <DEBUG|INFO|WARN|ERROR>" << endl;
-	cout << "\t\tSet the logging verbosity" << endl << endl;
+	cout << "\t-v --verbosity <DEBUG|INFO|WARN|ERROR|NONE>" << endl;
+	cout << "\t\tSet the logging verbosity (NONE disables logging)"
+	<< endl << endl;
+
+	cout << "\t-c --config <file>" << endl;
+	cout << "\t\tLoad the Ship and Factory probability tables from" << endl;
+	cout << "\t\tthe given file (see Config.hpp for its format)"
+	<< endl << endl;
+
+	cout << "\t-S --size <width>x<height>" << endl;
+	cout << "\t\tSet the Harbor's dimensions (in cells, at least 3"
+	<< endl;
+	cout << "\t\tcolumns so that ships enter between the docks)"
+	<< endl << endl;
+
+	cout << "\t-V --view <columns>x<rows>" << endl;
+	cout << "\t\tOnly display a viewport of the given dimensions (in" << endl;
+	cout << "\t\tcells, defaults to the terminal's size)" << endl << endl;
+
+	cout << "\t-z --zoom <unsigned integer>" << endl;
+	cout << "\t\tDisplay blocks of zoom x zoom cells as density" << endl;
+	cout << "\t\tglyphs (0 zooms out until the whole Harbor fits)"
+	<< endl << endl;
+
+	cout << "\t-f --follow" << endl;
+	cout << "\t\tKeep a moving Ship centered in the viewport" << endl << endl;
+
+	cout << "\t-m --metrics <prefix>" << endl;
+	cout << "\t\tExport the simulation metrics to <prefix>.prom" << endl;
+	cout << "\t\t(Prometheus text format) and <prefix>.csv"
+	<< endl << endl;
+
+	cout << "\t--metrics-period <unsigned integer>" << endl;
+	cout << "\t\tSet the number of Tower cycles between two metrics" << endl;
+	cout << "\t\texports (0 only exports at the end of the run)"
+	<< endl << endl;
+
+	cout << "\t-p --profile" << endl;
+	cout << "\t\tTime each Tower cycle phase and print their p50, p99"
+	<< endl;
+	cout << "\t\tand max durations at the end of the run" << endl << endl;
+
+	cout << "\t-t --trace <file>" << endl;
+	cout << "\t\tWrite a Chrome trace-event JSON timeline of the cycle"
+	<< endl;
+	cout << "\t\tphases, routes, dock assignments and frames to <file>"
+	<< endl << endl;
+
+	cout << "\t-Z --zero-alloc" << endl;
+	cout << "\t\tDisable logging and fail (exit code 1) if any cycle"
+	<< endl;
+	cout << "\t\tphase but Ship creation allocates heap memory once"
+	<< endl;
+	cout << "\t\twarmed up" << endl << endl;
+
+	cout << "\t-H --headless" << endl;
+	cout << "\t\tDon't display anything (simulation only)" << endl << endl;
+
+	cout << "\t--max-cycles <unsigned integer>" << endl;
+	cout << "\t\tStop each Tower loop after that many cycles (0 means"
+	<< endl;
+	cout << "\t\t\"until completion\")" << endl << endl;
+
+	cout << "\t--record <file>" << endl;
+	cout << "\t\tRecord every random draw and each cycle's state hash to"
+	<< endl;
+	cout << "\t\t<file>" << endl << endl;
+
+	cout << "\t--replay <file>" << endl;
+	cout << "\t\tReplay the draws recorded in <file> instead of rolling"
+	<< endl;
+	cout << "\t\tthem, and fail (exit code 1) if the state diverges"
+	<< endl << endl;
+
+	cout << "\t-A --arrivals <process>" << endl;
+	cout << "\t\tSet the Ship arrival process:" << endl;
+	cout << "\t\tbernoulli (default): one Ship at most per cycle" << endl;
+	cout << "\t\tpoisson:<rate>: <rate> Ships per cycle on average"
+	<< endl;
+	cout << "\t\tmmpp:<rate1>,<rate2>,<p12>,<p21>: bursty Poisson, switching"
+	<< endl;
+	cout << "\t\tfrom rate 1 to rate 2 with probability <p12> per cycle"
+	<< endl;
+	cout << "\t\t(and back with <p21>)" << endl;
+	cout << "\t\tschedule:<n1>,<n2>,...: <n1> Ships on the first cycle,"
+	<< endl;
+	cout << "\t\t<n2> on the second... then over again" << endl << endl;
+
+	cout << "\t--aging <positive or null float>" << endl;
+	cout << "\t\tPriority points gained by a waiting Ship per cycle spent"
+	<< endl;
+	cout << "\t\tin the queue (0 means \"strict priority order\")" << endl
+	<< endl;
+
+	cout << "\t--batch-docks <unsigned integer>" << endl;
+	cout << "\t\tEvery that many cycles, reassign the docks of the Ships"
+	<< endl;
+	cout << "\t\tstill travelling (and of the next queued ones) so as to"
+	<< endl;
+	cout << "\t\tminimize the priority-weighted travel distance (0 means"
+	<< endl;
+	cout << "\t\t\"first accepted dock only\")" << endl << endl;
+
+	cout << "\t-E --events" << endl;
+	cout << "\t\tRun the filling cycle as a discrete-event simulation:"
+	<< endl;
+	cout << "\t\tonly the Ships with pending events are handled, and idle"
+	<< endl;
+	cout << "\t\tcycles are skipped" << endl << endl;
+
+	cout << "\t-R --routing <strategy>" << endl;
+	cout << "\t\tSet the route planning strategy:" << endl;
+	cout << "\t\tstraight (default): head straight to the destination"
+	<< endl;
+	cout << "\t\tdstar: shortest route around the Ships that can't be"
+	<< endl;
+	cout << "\t\tcrushed, repaired incrementally as the surface changes"
+	<< endl;
+	cout << "\t\thpa: route around every Ship across clusters of cells,"
+	<< endl;
+	cout << "\t\tfor the largest harbors" << endl << endl;
+
+	cout << "\t--watchdog <unsigned integer>" << endl;
+	cout << "\t\tEnd the run (exit code 1) once that many cycles in a row"
+	<< endl;
+	cout << "\t\twent by without any Ship docking or leaving while Ships"
+	<< endl;
+	cout << "\t\tstill had to move (a livelock; 0 means \"never\","
+	<< endl;
+	cout << "\t\tdefaults to " << DEFAULT_WATCHDOG << ")" << endl << endl;
+
+	cout << "\t--congestion <positive or null float>" << endl;
+	cout << "\t\tWeight of the recent traffic through a cell when a"
+	<< endl;
+	cout << "\t\tstraight-routed Ship picks its next step: it takes the"
+	<< endl;
+	cout << "\t\tother way to its destination when that way is less busy"
+	<< endl;
+	cout << "\t\tby more than one step's worth (0 means \"ignore the"
+	<< endl;
+	cout << "\t\ttraffic\")" << endl << endl;
 
 	cout << "\trun" << endl;
 	cout << "\t\tRun the simulation (nothing runs if not set)" << endl;
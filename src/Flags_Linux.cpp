@@ -38,7 +38,7 @@ void Flags::parseCycleDelay(string const & s)
 		// Base 10 string to unsigned int conversion
 		delay = stoul(s);
 	}
-	catch(invalid_argument)	// Conversion failure (bad string given)
+	catch(invalid_argument const &)	// Conversion failure (bad string)
 	{
 		cout << "Bad cycle delay value \"" << s;
 		cout << "\" (positive or null integer expected)" << endl;
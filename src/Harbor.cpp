@@ -22,7 +22,10 @@
 
 #include "../include/Harbor.hpp"
 
+#include "../include/Hull.hpp"	// Hull
 #include "../include/Flags.hpp"	// Flags
+#include "../include/Metrics.hpp"	// Metrics
+#include "../include/Die.hpp"		// Die
 #include <numeric>		// std::iota
 #include <algorithm>		// std::random_shuffle
 #include <vector>		// std::vector
@@ -38,21 +41,28 @@ Harbor * Harbor::_instance(nullptr);
 
 // The one and only available constructor
 Harbor::Harbor(unsigned const width, unsigned const height)
-: _log("Harbor.log"), _width(width), _height(height)
+: _log("Harbor.log"), _width(width), _height(height), _totalSpeed(0),
+_preemption(2 * height)
 {
 	// Entry points generation
 	_entryPoints.insert(Point(_width/2, 0));
 	if(_width % 2 == 0)
 		_entryPoints.insert(Point(_width/2-1, 0));
+	_exitMap.build(_width, _height, _entryPoints);
+	_heat.resize(_width, _height);
 
 	// Will contain the dock IDs (ordered randomly)
 	vector<unsigned> dockIds(2 * _height);
 	// Dock IDs preparation (iota then permutation)
 	iota(dockIds.begin(), dockIds.end(), 1);
 	if(Flags::randomizeDocks())
-		random_shuffle(dockIds.begin(), dockIds.end());
+		random_shuffle(dockIds.begin(), dockIds.end(), Die::rollLegacy);
 
-	_availableDocks = set<unsigned>(dockIds.begin(), dockIds.end());
+	_availableDocks = DockSet(dockIds.begin(), dockIds.end());
+	// A mass departure refills the set while the nodes of the docks
+	// reserved last are still in use: keep one spare node per dock so that
+	// it doesn't allocate in the middle of a run (see --zero-alloc)
+	reserveNodes(_availableDocks);
 
 	// Lets assign the dock IDs
 	for(unsigned i = 0 ; i < _height ; ++i)
@@ -101,7 +111,7 @@ void Harbor::deleteInstance()
 bool Harbor::addShip(Ship const * s, Point const & p)
 {
 	set<Point>::const_iterator entryPointIt(_entryPoints.find(p));
-	map<Point, Ship const *>::const_iterator shipIt(_surface.find(p));
+	Surface::const_iterator shipIt(_surface.find(p));
 
 	// If the given Point isn't in the entry points list
 	if(entryPointIt == _entryPoints.end())
@@ -120,6 +130,13 @@ bool Harbor::addShip(Ship const * s, Point const & p)
 	// Else, assume everything is fine
 	_surface.insert(make_pair(p,s));
 	_reverseSurface.insert(make_pair(s,p));
+	_changedCells.push_back(p);
+	_heat.add(p);
+
+	// Each step of each Ship may change two cells between two frames:
+	// size the list now rather than while moving
+	_totalSpeed += s->speed();
+	_changedCells.reserve(_changedCells.size() + 2 * _totalSpeed);
 
 	_log << info << "Added Ship " << s->name() << " at " << p << endl;
 
@@ -133,7 +150,7 @@ bool Harbor::addShip(Ship const & s, Point const & p)
 // Get the Ship located on the given Point
 Ship const * Harbor::getShipAt(Point const & p) const
 {
-	map<Point, Ship const *>::const_iterator shipIt(_surface.find(p));
+	Surface::const_iterator shipIt(_surface.find(p));
 
 	if(shipIt != _surface.end())
 		return shipIt->second;
@@ -156,7 +173,7 @@ Point Harbor::getShipPosition(Ship const * s) const
 // (if possible, see tests in the code)
 bool Harbor::moveShip(Point const & source, Point const & destination)
 {
-	map<Point, Ship const *>::const_iterator
+	Surface::const_iterator
 		sourceIt(_surface.find(source)),
 		destinationIt(_surface.find(destination));
 
@@ -185,6 +202,7 @@ bool Harbor::moveShip(Point const & source, Point const & destination)
 		{
 			// We can't crush the other Ship: the controller will
 			// have to get around it
+			Metrics::increment(BLOCKED_MOVES);
 			return false;
 		}
 		else
@@ -203,15 +221,19 @@ bool Harbor::moveShip(Point const & source, Point const & destination)
 
 			// Revoke his dock reservation... he will no longer
 			// need it :/
+			_preemption.erase(_reservations[victim->name()]);
 			_availableDocks.insert(_reservations[victim->name()]);
 			_reservations.erase(victim->name());
 
 			// Remove it from the surface, and then...
 			_surface.erase(destination);
 			_reverseSurface.erase(victim);
+			_totalSpeed -= victim->speed();
+			_changedCells.push_back(destination);
 
 			// This. Is. SPARTAAAAA!
 			delete victim;
+			Metrics::increment(COLLISIONS);
 
 			return true;
 		}
@@ -219,12 +241,19 @@ bool Harbor::moveShip(Point const & source, Point const & destination)
 
 	// Everything should be fine from now on
 
-	_reverseSurface[_surface[source]] = destination;
-	_surface[destination] = _surface[source];
+	// (erasing the source first lets the destination reuse its node)
+	Ship const * ship(sourceIt->second);
+
 	_surface.erase(source);
+	_surface[destination] = ship;
+	_reverseSurface[ship] = destination;
+	_changedCells.push_back(source);
+	_changedCells.push_back(destination);
+	_heat.add(destination);
 
-	_log << info << "Moved Ship " << _surface[destination]->name()
+	_log << info << "Moved Ship " << ship->name()
 	<< " from " << source << " to " << destination << endl;
+	Metrics::increment(MOVES);
 
 	return true;
 }
@@ -239,6 +268,8 @@ bool Harbor::removeReservation(string const & name)
 	if(reservationIt != _reservations.end())
 	{
 		// erase it from the reservations map
+		// (the index first: the freed set node is then reused)
+		_preemption.erase(reservationIt->second);
 		_availableDocks.insert(reservationIt->second);
 		_reservations.erase(reservationIt);
 
@@ -251,7 +282,7 @@ bool Harbor::removeReservation(string const & name)
 // Remove, if any, the Ship emplaced in the given position
 bool Harbor::removeShip(Point const & p)
 {
-	map<Point, Ship const *>::const_iterator shipIt(_surface.find(p));
+	Surface::const_iterator shipIt(_surface.find(p));
 
 	// If there's no Ship on the given point
 	if(shipIt == _surface.end())
@@ -262,9 +293,11 @@ bool Harbor::removeShip(Point const & p)
 
 	// Else, assume everything is fine and proceed
 	removeReservation(shipIt->second->name());
+	_totalSpeed -= shipIt->second->speed();
 
 	_reverseSurface.erase(_surface[p]);
 	_surface.erase(p);
+	_changedCells.push_back(p);
 
 	return true;
 }
@@ -292,7 +325,9 @@ bool Harbor::removeShip(Ship const * s)
 
 	// Proceed
 	removeReservation(s->name());
+	_totalSpeed -= s->speed();
 
+	_changedCells.push_back(_reverseSurface[s]);
 	_surface.erase(_reverseSurface[s]);
 	_reverseSurface.erase(s);
 
@@ -305,12 +340,56 @@ set<Point> const & Harbor::entryPoints() const
 	return _entryPoints;
 }
 
+// Get a reference to the nearest entry point map
+ExitMap const & Harbor::exitMap() const
+{
+	return _exitMap;
+}
+
 // Get a reference to the non-mutable map representing the Harbor's surface
-map<Point, Ship const *> const & Harbor::surface() const
+Surface const & Harbor::surface() const
 {
 	return _surface;
 }
 
+// Sum of the surface's Ships speeds (most steps a cycle may plan)
+unsigned long Harbor::totalSpeed() const
+{
+	return _totalSpeed;
+}
+
+// FNV-1a over the (ordered) surface then the reservations
+uint64_t Harbor::stateHash() const
+{
+	uint64_t h(14695981039346656037ULL);
+	auto mix = [&h](uint64_t const v)
+	{
+		for(unsigned i = 0 ; i < 8 ; ++i)
+			h = (h ^ ((v >> (8 * i)) & 0xff)) * 1099511628211ULL;
+	};
+	auto mixString = [&h](string const & str)
+	{
+		for(unsigned char c : str)
+			h = (h ^ c) * 1099511628211ULL;
+		h = (h ^ 0xff) * 1099511628211ULL;
+	};
+
+	for(auto const & cell : _surface)
+	{
+		mix(uint64_t(uint32_t(cell.first.x())) << 32
+			| uint32_t(cell.first.y()));
+		mixString(cell.second->name());
+	}
+
+	for(auto const & reservation : _reservations)
+	{
+		mixString(reservation.first);
+		mix(reservation.second);
+	}
+
+	return h;
+}
+
 // Get a reference to the non-mutable reversed map representing the Harbor's
 // surface
 map<Ship const *, Point> const & Harbor::reverseSurface() const
@@ -318,6 +397,31 @@ map<Ship const *, Point> const & Harbor::reverseSurface() const
 	return _reverseSurface;
 }
 
+// Get a reference to the non-mutable list of cells whose content changed
+// since the last call to clearChangedCells() (a cell may appear twice)
+vector<Point> const & Harbor::changedCells() const
+{
+	return _changedCells;
+}
+
+// Forget the changed cells
+void Harbor::clearChangedCells()
+{
+	_changedCells.clear();
+}
+
+// Get a reference to the non-mutable traffic heat of the cells
+HeatMap const & Harbor::heat() const
+{
+	return _heat;
+}
+
+// Let the traffic heat decay until the given (Tower) cycle
+void Harbor::coolDown(uint64_t const cycle)
+{
+	_heat.advance(cycle);
+}
+
 /*
  * Docks-related methods
  */
@@ -339,7 +443,7 @@ Point Harbor::getDockPosition(unsigned const id) const
 }
 
 // Get a reference to the non-mutable set of available docks
-set<unsigned> const & Harbor::availableDocks() const
+DockSet const & Harbor::availableDocks() const
 {
 	return _availableDocks;
 }
@@ -347,7 +451,7 @@ set<unsigned> const & Harbor::availableDocks() const
 // Reserve the given dock for the given Ship
 bool Harbor::reserveDock(unsigned const dockId, Ship const * const s)
 {
-	set<unsigned>::const_iterator
+	DockSet::const_iterator
 		availableDocksIt(_availableDocks.find(dockId));
 
 	map<string, unsigned>::const_iterator
@@ -369,6 +473,7 @@ bool Harbor::reserveDock(unsigned const dockId, Ship const * const s)
 		_availableDocks.erase(dockId);
 		// Add a reservation entry
 		_reservations.insert(make_pair(s->name(), dockId));
+		_preemption.insert(dockId, s);
 
 		_log << info << "Reserved dock n°" << dockId << " for Ship "
 		<< s->name() << endl;
@@ -387,6 +492,37 @@ bool Harbor::reserveDock(unsigned const dockId, Ship const & s)
 	return reserveDock(dockId, &s);
 }
 
+// Give each given Ship its new dock: release every old dock first, then
+// take the new ones (the reservation entries are updated in place)
+void Harbor::reassignDocks(vector<pair<Ship const *, unsigned>> const & changes)
+{
+	for(auto const & change : changes)
+	{
+		unsigned const dockId(getReservedDock(change.first));
+
+		_preemption.erase(dockId);
+		_availableDocks.insert(dockId);
+	}
+
+	for(auto const & change : changes)
+	{
+		_log << info << "Dock n°" << change.second
+		<< " reassigned to Ship " << change.first->name()
+		<< " (was n°" << getReservedDock(change.first) << ")" << endl;
+
+		_availableDocks.erase(change.second);
+		_reservations.find(change.first->name())->second
+			= change.second;
+		_preemption.insert(change.second, change.first);
+	}
+}
+
+// Get the Ship whose dock the given Ship may take over (see PreemptionIndex)
+Ship const * Harbor::evictionCandidate(Ship const * const s)
+{
+	return _preemption.candidate(s);
+}
+
 // Get the reserved dock ID for the given Ship
 unsigned Harbor::getReservedDock(Ship const * const s) const
 {
@@ -430,7 +566,7 @@ map<Point, unsigned> const & Harbor::reverseDockMap() const
 // Handles collisions between two Ships, comparing their respective hulls
 bool Harbor::collision(Ship const * const s1, Ship const * const s2)
 {
-	if(s1->hull() > s2->hull())
+	if((*s2->hull()) < (*s1->hull()))
 	{
 		// "false" means "We don't care anymore"
 		// (from s1's point of view)
@@ -32,7 +32,7 @@ using namespace std;
 void Harbor::display() const
 {
 	map<Point, unsigned>::const_iterator di;	// Dock iterator
-	map<Point, Ship const *>::const_iterator si;	// Ship iterator
+	Surface::const_iterator si;	// Ship iterator
 	set<Point>::const_iterator epi;			// Entry point iterator
 
 	// ASCII display header
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2016 Julien "Derjik" Laurent <julien.laurent@engineer.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "../include/HeatMap.hpp"
+
+#include <cmath>	// pow()
+
+using namespace std;
+
+
+HeatMap::HeatMap() : _width(0), _scale(1.f), _cycle(0)
+{
+}
+
+void HeatMap::resize(unsigned const width, unsigned const height)
+{
+	_width = width;
+	_cells.assign(width * height, 0.f);
+	_scale = 1.f;
+}
+
+void HeatMap::advance(uint64_t const cycle)
+{
+	if(cycle <= _cycle)
+		return;
+
+	_scale *= pow(1.f / HEAT_DECAY, float(cycle - _cycle));
+	_cycle = cycle;
+
+	// (an infinite scale means every cell cooled down completely)
+	if(!(_scale < HEAT_RESCALE))
+	{
+		for(float & c : _cells)
+			c /= _scale;
+		_scale = 1.f;
+	}
+}
@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2016 Julien "Derjik" Laurent <julien.laurent@engineer.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "../include/JumpPointSearch.hpp"
+
+#include <algorithm>			// std::push_heap, std::pop_heap, std::fill
+#include <cstdlib>			// abs()
+#include "../include/Metrics.hpp"	// Metrics
+
+using namespace std;
+
+
+// Step (-1, 0 or 1) from a to b along one axis
+static int sign(int const a, int const b)
+{
+	return (b > a) - (b < a);
+}
+
+
+JumpPointSearch::JumpPointSearch(vector<bool> const & blocked,
+				unsigned const width, unsigned const area)
+	: _blocked(blocked), _width(width),
+	_left(0), _top(0), _right(0), _bottom(0),
+	_g(area), _parent(area), _stamp(area, 0), _generation(0)
+{
+	_heap.reserve(area);
+}
+
+uint32_t JumpPointSearch::find(Point const & start, Point const & goal,
+				Point const & topLeft, Point const & bottomRight,
+				vector<Point> * const path)
+{
+	uint64_t expansions(0);
+	Point jump;
+
+	_left = topLeft.x();
+	_top = topLeft.y();
+	_right = bottomRight.x();
+	_bottom = bottomRight.y();
+	_start = start;
+	_goal = goal;
+	_heap.clear();
+
+	if(++_generation == 0)
+	{
+		fill(_stamp.begin(), _stamp.end(), 0);
+		_generation = 1;
+	}
+
+	// (the start is its own parent)
+	reach(start, index(start), 0);
+
+	while(!_heap.empty())
+	{
+		pop_heap(_heap.begin(), _heap.end(), after);
+		Entry const e(_heap.back());
+		_heap.pop_back();
+
+		// Stale entry (reached shorter meanwhile)
+		if(e.g > _g[e.cell])
+			continue;
+
+		Point const p(point(e.cell));
+		int const dx(sign(point(_parent[e.cell]).x(), p.x())),
+			dy(sign(point(_parent[e.cell]).y(), p.y()));
+
+		++expansions;
+
+		if(p == _goal)
+		{
+			Metrics::increment(ROUTE_EXPANSIONS, expansions);
+
+			if(path != nullptr)
+			{
+				// Unwind the jumps, filling the cells backwards
+				size_t at(path->size() + e.g);
+				uint32_t cell(e.cell);
+
+				path->resize(at);
+				for( ; _parent[cell] != cell ;
+					cell = _parent[cell])
+				{
+					Point const from(point(_parent[cell]));
+
+					for(Point c(point(cell)) ; c != from ;
+						c = c + Point(sign(c.x(), from.x()),
+							sign(c.y(), from.y())))
+						(*path)[--at] = c;
+				}
+			}
+
+			return e.g;
+		}
+
+		// Horizontal jumps: both ways from the start and after a
+		// vertical move, straight on after a horizontal one
+		for(int h = -1 ; h <= 1 ; h += 2)
+			if((dx == 0 || dx == h) && jumpHorizontal(p, h, jump))
+				reach(jump, e.cell, e.g + abs(jump.x() - p.x()));
+
+		// Vertical jumps: both ways from the start, straight on after
+		// a vertical move, and around an obstacle just behind after
+		// a horizontal one
+		for(int v = -1 ; v <= 1 ; v += 2)
+			if((dy == v || (dx == 0 && dy == 0)
+			|| (dx != 0 && free(p.x(), p.y() + v)
+				&& !free(p.x() - dx, p.y() + v)))
+			&& jumpVertical(p, v, jump))
+				reach(jump, e.cell, e.g + abs(jump.y() - p.y()));
+	}
+
+	Metrics::increment(ROUTE_EXPANSIONS, expansions);
+	return UINT32_MAX;
+}
+
+bool JumpPointSearch::free(int const x, int const y) const
+{
+	if(x < _left || x > _right || y < _top || y > _bottom)
+		return false;
+
+	Point const p(x, y);
+
+	return p == _start || p == _goal || !_blocked[x + y * _width];
+}
+
+// Stops on the goal and where a vertical turn gets needed
+bool JumpPointSearch::jumpHorizontal(Point const & from, int const dx,
+					Point & jump) const
+{
+	for(Point c(from.x() + dx, from.y()) ; free(c.x(), c.y()) ;
+		c = Point(c.x() + dx, c.y()))
+		if(c == _goal
+		|| (free(c.x(), c.y() - 1) && !free(c.x() - dx, c.y() - 1))
+		|| (free(c.x(), c.y() + 1) && !free(c.x() - dx, c.y() + 1)))
+		{
+			jump = c;
+			return true;
+		}
+
+	return false;
+}
+
+// Stops on the goal and where a horizontal jump finds something
+bool JumpPointSearch::jumpVertical(Point const & from, int const dy,
+					Point & jump) const
+{
+	Point side;
+
+	for(Point c(from.x(), from.y() + dy) ; free(c.x(), c.y()) ;
+		c = Point(c.x(), c.y() + dy))
+		if(c == _goal || jumpHorizontal(c, -1, side)
+		|| jumpHorizontal(c, 1, side))
+		{
+			jump = c;
+			return true;
+		}
+
+	return false;
+}
+
+void JumpPointSearch::reach(Point const & p, uint32_t const parent,
+				uint32_t const g)
+{
+	uint32_t const cell(index(p));
+
+	if(_stamp[cell] == _generation && _g[cell] <= g)
+		return;
+
+	_stamp[cell] = _generation;
+	_g[cell] = g;
+	_parent[cell] = parent;
+
+	_heap.push_back({g + abs(p.x() - _goal.x()) + abs(p.y() - _goal.y()),
+			g, cell});
+	push_heap(_heap.begin(), _heap.end(), after);
+}
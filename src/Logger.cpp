@@ -82,6 +82,9 @@ string Logger::level() const
 		case ERROR:
 			l = "[ERROR]";
 		break;
+
+		case NONE:
+		break;
 	}
 
 	return l;
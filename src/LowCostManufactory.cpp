@@ -23,6 +23,7 @@
 #include "../include/LowCostManufactory.hpp"
 
 #include "../include/Die.hpp"			// Die
+#include "../include/Config.hpp"		// Config
 #include "../include/CheapEngine.hpp"		// CheapEngine
 #include "../include/ExpensiveEngine.hpp"	// ExpensiveEngine
 #include "../include/CheapHull.hpp"		// CheapHull
@@ -34,20 +35,20 @@
 Engine* LowCostManufactory::createEngine() const
 {
 	Engine* e(nullptr);
-	unsigned result(Die::roll(1, 6));
+	unsigned result(Die::roll(Config::lowCostEngines()));
 
 	switch(result)
 	{
-		case 6:
+		case 2:
 			e = new ExpensiveEngine();
 		break;
 
-		case 5:
-		case 4:
+		case 1:
 			e = new Turbocharger(new CheapEngine());
 		break;
 
 		default:
+		case 0:
 			e = new CheapEngine();
 		break;
 	}
@@ -58,23 +59,24 @@ Engine* LowCostManufactory::createEngine() const
 Hull* LowCostManufactory::createHull() const
 {
 	Hull* h(nullptr);
-	unsigned result(Die::roll(1, 6));
+	unsigned result(Die::roll(Config::lowCostHulls()));
 
 	switch(result)
 	{
-		case 6:
+		case 3:
 			h = new ExpensiveHull();
 		break;
 
-		case 5:
+		case 2:
 			h = new GoldPlating(new GoldPlating(new CheapHull()));
 		break;
 
-		case 4:
+		case 1:
 			h = new GoldPlating(new CheapHull());
 		break;
 
 		default:
+		case 0:
 			h = new CheapHull();
 		break;
 	}
@@ -0,0 +1,291 @@
+/*
+ * Copyright (c) 2016 Julien "Derjik" Laurent <julien.laurent@engineer.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "../include/Metrics.hpp"
+
+#include <fstream>		// std::ofstream
+#include <cstdio>		// std::rename()
+#include "../include/Flags.hpp"	// Flags
+
+using namespace std;
+
+
+// Exported names and descriptions
+static char const * const counterNames[COUNTER_COUNT][2] =
+{
+	{"harbor_moves_total", "Moves applied onto the surface"},
+	{"harbor_collisions_total", "Ships crushed during a move"},
+	{"harbor_blocked_moves_total",
+		"Moves refused because of a stronger Ship"},
+	{"tower_stay_puts_total", "Planned steps waiting behind an obstacle"},
+	{"tower_engine_failures_total",
+		"Planned steps lost to an engine failure"},
+	{"tower_evictions_total",
+		"Reservations taken over by a higher priority Ship"},
+	{"tower_ships_created_total", "Ships built by the Tower"},
+	{"tower_ships_rejected_total",
+		"Ships deleted for lack of a suitable dock"},
+	{"tower_ships_departed_total", "Ships which left the Harbor"},
+	{"tower_cycles_total", "Tower cycles"},
+	{"tower_ship_cycles_total", "Ships on the surface, summed over cycles"},
+	{"tower_turned_away_total",
+		"Arrivals dropped (every dock already promised)"},
+	{"tower_reassignments_total",
+		"Reservations moved by the batch assignment or a deadlock"},
+	{"tower_route_expansions_total",
+		"Cells expanded by the route searches"},
+	{"tower_deadlocks_total", "Wait cycles and endless waits broken"},
+	{"tower_back_offs_total", "Ships stepped aside to break a wait"}
+};
+
+static char const * const gaugeNames[GAUGE_COUNT][2] =
+{
+	{"tower_queue_length", "Ships waiting to enter the Harbor"},
+	{"harbor_available_docks", "Docks available for reservation"},
+	{"harbor_ships", "Ships inside the Harbor"},
+	{"tower_stalled_cycles",
+		"Cycles in a row without a Ship docking or leaving (livelock)"}
+};
+
+static char const * const histogramNames[HISTOGRAM_COUNT][2] =
+{
+	{"tower_cycle_moves", "Moves applied per cycle"}
+};
+
+// Buckets upper bounds (the last one stands for +Inf)
+static double const bucketBounds[HISTOGRAM_BUCKETS - 1] =
+{
+	0, 1, 2, 5, 10, 20, 50, 100, 200, 500, 1000
+};
+
+
+thread_local Metrics::Block * Metrics::_local(nullptr);
+vector<Metrics::Block *> Metrics::_blocks;
+mutex Metrics::_blocksMutex;
+atomic<double> Metrics::_gauges[GAUGE_COUNT];
+uint64_t Metrics::_cycles(0);
+uint64_t Metrics::_lastRow(0);
+bool Metrics::_csvHeaderWritten(false);
+
+
+// Create the calling thread's block
+void Metrics::registerThread()
+{
+	Block * b(new Block);
+
+	for(auto & c : b->counters)
+		c.store(0);
+	for(auto & h : b->buckets)
+		for(auto & c : h)
+			c.store(0);
+	for(auto & s : b->sums)
+		s.store(0.);
+
+	lock_guard<mutex> lock(_blocksMutex);
+	_blocks.push_back(b);
+	_local = b;
+}
+
+// Index of the bucket holding the given value
+unsigned Metrics::bucket(double const value)
+{
+	unsigned i(0);
+
+	while(i < HISTOGRAM_BUCKETS - 1 && value > bucketBounds[i])
+		++i;
+
+	return i;
+}
+
+// Record a value into the given histogram
+void Metrics::observe(Histogram const h, double const value)
+{
+	Block & b(local());
+
+	add(b.buckets[h][bucket(value)], 1);
+	b.sums[h].store(b.sums[h].load(memory_order_relaxed) + value,
+			memory_order_relaxed);
+}
+
+// Sum a counter over every thread
+uint64_t Metrics::counter(Counter const c)
+{
+	uint64_t total(0);
+
+	lock_guard<mutex> lock(_blocksMutex);
+	for(auto b : _blocks)
+		total += b->counters[c].load(memory_order_relaxed);
+
+	return total;
+}
+
+// Get a gauge's last value
+double Metrics::gauge(Gauge const g)
+{
+	return _gauges[g].load(memory_order_relaxed);
+}
+
+// Count the cycle and export if the period is reached
+void Metrics::cycle()
+{
+	increment(CYCLES);
+	++_cycles;
+
+	if(Flags::metricsPeriod() != 0 && _cycles % Flags::metricsPeriod() == 0)
+		flush();
+}
+
+// Export every metric
+void Metrics::flush()
+{
+	if(Flags::metricsPrefix().empty())
+		return;
+
+	exportPrometheus(Flags::metricsPrefix() + ".prom");
+	exportCSV(Flags::metricsPrefix() + ".csv");
+}
+
+// Write the Prometheus text exposition format (through a temporary file,
+// so that scrapers never read a partial export)
+void Metrics::exportPrometheus(string const & path)
+{
+	ofstream file(path + ".tmp", ios::trunc | ios::out);
+	uint64_t buckets[HISTOGRAM_BUCKETS];
+	uint64_t cumulated(0);
+	double sum(0.);
+
+	for(unsigned c = 0 ; c < COUNTER_COUNT ; ++c)
+	{
+		file << "# HELP " << counterNames[c][0] << " "
+		<< counterNames[c][1] << "\n";
+		file << "# TYPE " << counterNames[c][0] << " counter\n";
+		file << counterNames[c][0] << " " << counter(Counter(c)) << "\n";
+	}
+
+	for(unsigned g = 0 ; g < GAUGE_COUNT ; ++g)
+	{
+		file << "# HELP " << gaugeNames[g][0] << " "
+		<< gaugeNames[g][1] << "\n";
+		file << "# TYPE " << gaugeNames[g][0] << " gauge\n";
+		file << gaugeNames[g][0] << " " << gauge(Gauge(g)) << "\n";
+	}
+
+	for(unsigned h = 0 ; h < HISTOGRAM_COUNT ; ++h)
+	{
+		// Sum the buckets over every thread
+		for(auto & b : buckets)
+			b = 0;
+		sum = 0.;
+		{
+			lock_guard<mutex> lock(_blocksMutex);
+			for(auto block : _blocks)
+			{
+				for(unsigned i = 0 ; i < HISTOGRAM_BUCKETS ; ++i)
+					buckets[i] += block->buckets[h][i]
+						.load(memory_order_relaxed);
+				sum += block->sums[h].load(memory_order_relaxed);
+			}
+		}
+
+		file << "# HELP " << histogramNames[h][0] << " "
+		<< histogramNames[h][1] << "\n";
+		file << "# TYPE " << histogramNames[h][0] << " histogram\n";
+
+		// Prometheus buckets are cumulative
+		cumulated = 0;
+		for(unsigned i = 0 ; i < HISTOGRAM_BUCKETS ; ++i)
+		{
+			cumulated += buckets[i];
+			file << histogramNames[h][0] << "_bucket{le=\"";
+			if(i < HISTOGRAM_BUCKETS - 1)
+				file << bucketBounds[i];
+			else
+				file << "+Inf";
+			file << "\"} " << cumulated << "\n";
+		}
+		file << histogramNames[h][0] << "_sum " << sum << "\n";
+		file << histogramNames[h][0] << "_count " << cumulated << "\n";
+	}
+
+	file.close();
+	rename((path + ".tmp").c_str(), path.c_str());
+}
+
+// Append a row of values (the first export writes the header)
+void Metrics::exportCSV(string const & path)
+{
+	uint64_t count(0);
+	double sum(0.);
+
+	// Don't write the same cycle twice (final flush)
+	if(_csvHeaderWritten && _lastRow == _cycles)
+		return;
+	_lastRow = _cycles;
+
+	ofstream file(path, _csvHeaderWritten ? ios::app : ios::trunc);
+
+	if(!_csvHeaderWritten)
+	{
+		file << "cycle";
+		for(unsigned c = 0 ; c < COUNTER_COUNT ; ++c)
+			file << "," << counterNames[c][0];
+		for(unsigned g = 0 ; g < GAUGE_COUNT ; ++g)
+			file << "," << gaugeNames[g][0];
+		for(unsigned h = 0 ; h < HISTOGRAM_COUNT ; ++h)
+			file << "," << histogramNames[h][0] << "_count,"
+			<< histogramNames[h][0] << "_sum";
+		file << "\n";
+
+		_csvHeaderWritten = true;
+	}
+
+	file << _cycles;
+	for(unsigned c = 0 ; c < COUNTER_COUNT ; ++c)
+		file << "," << counter(Counter(c));
+	for(unsigned g = 0 ; g < GAUGE_COUNT ; ++g)
+		file << "," << gauge(Gauge(g));
+	for(unsigned h = 0 ; h < HISTOGRAM_COUNT ; ++h)
+	{
+		count = 0;
+		sum = 0.;
+		lock_guard<mutex> lock(_blocksMutex);
+		for(auto block : _blocks)
+		{
+			for(auto & b : block->buckets[h])
+				count += b.load(memory_order_relaxed);
+			sum += block->sums[h].load(memory_order_relaxed);
+		}
+		file << "," << count << "," << sum;
+	}
+	file << "\n";
+}
+
+// Free every block (no more recording allowed afterwards)
+void Metrics::clean()
+{
+	lock_guard<mutex> lock(_blocksMutex);
+
+	for(auto b : _blocks)
+		delete b;
+	_blocks.clear();
+	_local = nullptr;
+}
@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2016 Julien "Derjik" Laurent <julien.laurent@engineer.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "../include/PerfCounters.hpp"
+
+#include <cstring>		// memset(), strerror()
+#include <cerrno>		// errno
+#include <iomanip>		// std::setw, std::setprecision
+#include <unistd.h>		// syscall(), read(), close()
+#include <sys/ioctl.h>		// ioctl()
+#include <sys/syscall.h>	// __NR_perf_event_open
+#include <linux/perf_event.h>	// perf_event_attr, PERF_*
+
+using namespace std;
+
+
+// Counter configurations (same order as PerfCounter)
+static uint64_t const counterConfigs[PERF_COUNTER_COUNT] =
+{
+	PERF_COUNT_HW_CPU_CYCLES,
+	PERF_COUNT_HW_INSTRUCTIONS,
+	PERF_COUNT_HW_CACHE_MISSES,
+	PERF_COUNT_HW_BRANCH_MISSES
+};
+
+// Counters file descriptors (the first one is the group leader)
+static int counterFds[PERF_COUNTER_COUNT] = {-1, -1, -1, -1};
+
+bool PerfCounters::_available(false);
+string PerfCounters::_error("not opened");
+uint64_t PerfCounters::_totals[PHASE_COUNT][PERF_COUNTER_COUNT];
+
+
+bool PerfCounters::open()
+{
+	perf_event_attr attr;
+
+	for(unsigned i = 0 ; i < PERF_COUNTER_COUNT ; ++i)
+	{
+		memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.config = counterConfigs[i];
+		attr.read_format = PERF_FORMAT_GROUP;
+		attr.disabled = (i == 0);
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+
+		counterFds[i] = syscall(__NR_perf_event_open, &attr, 0, -1,
+				i == 0 ? -1 : counterFds[0], 0);
+
+		if(counterFds[i] < 0)
+		{
+			_error = strerror(errno);
+			close();
+			return false;
+		}
+	}
+
+	ioctl(counterFds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+	ioctl(counterFds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+
+	_available = true;
+	return true;
+}
+
+void PerfCounters::close()
+{
+	for(auto & fd : counterFds)
+	{
+		if(fd >= 0)
+			::close(fd);
+		fd = -1;
+	}
+
+	_available = false;
+}
+
+void PerfCounters::read(uint64_t values[PERF_COUNTER_COUNT])
+{
+	// Group read format: number of counters, then their values
+	uint64_t group[PERF_COUNTER_COUNT + 1] = {0};
+
+	if(!_available
+	|| ::read(counterFds[0], group, sizeof(group)) != sizeof(group))
+		memset(group, 0, sizeof(group));
+
+	for(unsigned i = 0 ; i < PERF_COUNTER_COUNT ; ++i)
+		values[i] = group[i + 1];
+}
+
+void PerfCounters::add(Phase const p,
+		uint64_t const start[PERF_COUNTER_COUNT],
+		uint64_t const end[PERF_COUNTER_COUNT])
+{
+	for(unsigned i = 0 ; i < PERF_COUNTER_COUNT ; ++i)
+		_totals[p][i] += end[i] - start[i];
+}
+
+// Print one line per phase (misses are averaged per phase call)
+void PerfCounters::report(ostream & out, uint64_t const calls[PHASE_COUNT])
+{
+	if(!_available)
+	{
+		out << endl << "Hardware counters unavailable (" << _error
+		<< ")" << endl;
+		return;
+	}
+
+	out << endl << left << setw(12) << "phase" << right
+	<< setw(10) << "IPC" << setw(18) << "cache-miss/call"
+	<< setw(18) << "branch-miss/call" << endl;
+
+	out << fixed << setprecision(2);
+	for(unsigned i = 0 ; i < PHASE_COUNT ; ++i)
+	{
+		Phase const p(static_cast<Phase>(i));
+
+		if(calls[p] == 0)
+			continue;
+
+		out << left << setw(12) << Profiler::name(p) << right
+		<< setw(10) << (_totals[p][CPU_CYCLES] == 0 ? 0.
+			: double(_totals[p][INSTRUCTIONS])
+				/ _totals[p][CPU_CYCLES])
+		<< setw(18) << double(_totals[p][CACHE_MISSES]) / calls[p]
+		<< setw(18) << double(_totals[p][BRANCH_MISSES]) / calls[p]
+		<< endl;
+	}
+	out.unsetf(ios::floatfield);
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2016 Julien "Derjik" Laurent <julien.laurent@engineer.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "../include/PerfCounters.hpp"
+
+#include <cstring>		// memset()
+
+using namespace std;
+
+
+/*
+ * No perf_event_open() outside of Linux: counters stay unavailable.
+ */
+
+bool PerfCounters::_available(false);
+string PerfCounters::_error("not supported on this OS");
+uint64_t PerfCounters::_totals[PHASE_COUNT][PERF_COUNTER_COUNT];
+
+
+bool PerfCounters::open()
+{
+	return false;
+}
+
+void PerfCounters::close()
+{}
+
+void PerfCounters::read(uint64_t values[PERF_COUNTER_COUNT])
+{
+	memset(values, 0, PERF_COUNTER_COUNT * sizeof(uint64_t));
+}
+
+void PerfCounters::add(Phase const, uint64_t const [PERF_COUNTER_COUNT],
+		uint64_t const [PERF_COUNTER_COUNT])
+{}
+
+void PerfCounters::report(ostream & out, uint64_t const [PHASE_COUNT])
+{
+	out << endl << "Hardware counters unavailable (" << _error << ")"
+	<< endl;
+}
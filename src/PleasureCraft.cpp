@@ -36,11 +36,10 @@ float PleasureCraft::failureProbability() const
 	return 0.05f;
 }
 
-bool PleasureCraft::accept(unsigned dockId) const
+bool PleasureCraft::accept(unsigned) const
 {
-	// This trivial comparison pleases the compiler and avoid warnings
-	// (-Wunused)
-	return (dockId==dockId);
+	// Any dock will do
+	return true;
 }
 
 unsigned PleasureCraft::priority() const
@@ -23,6 +23,7 @@
 #include "../include/Point.hpp"
 
 #include <sstream>		// std::ostringstream
+#include <cstdlib>		// abs()
 
 using namespace std;
 
@@ -142,10 +143,5 @@ ostream & operator << (ostream & s, Direction const & d)
 // Manhattan distance between two Points
 unsigned manhattanDistance(Point const & a, Point const & b)
 {
-	unsigned d(0);
-
-	d += (b._x - a._x) * (b._x - a._x);
-	d += (b._y - a._y) * (b._y - a._y);
-
-	return d;
+	return abs(b._x - a._x) + abs(b._y - a._y);
 }
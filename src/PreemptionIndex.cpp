@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2016 Julien "Derjik" Laurent <julien.laurent@engineer.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "../include/PreemptionIndex.hpp"
+
+#include <typeinfo>		// typeid
+#include "../include/Ship.hpp"	// Ship
+
+using namespace std;
+
+
+PreemptionIndex::PreemptionIndex(unsigned const docks)
+	: _holders(docks + 1, nullptr)
+{}
+
+// Get (or build) the given Ship's class view
+PreemptionIndex::View & PreemptionIndex::view(Ship const * const s)
+{
+	type_index const type(typeid(*s));
+	map<type_index, View>::iterator it(_views.find(type));
+
+	if(it == _views.end())
+	{
+		View & v(_views[type]);
+		Docks warm;
+
+		v.accepts.resize(_holders.size(), false);
+		for(unsigned d = 1 ; d < _holders.size() ; ++d)
+			if((v.accepts[d] = s->accept(d)))
+				warm.insert(d);
+
+		// The view's sets never hold more than the accepted docks:
+		// hand that many nodes to the pool right away, so that
+		// indexing reservations never has to allocate
+		warm.clear();
+
+		// Index the current reservations
+		for(unsigned d = 1 ; d < _holders.size() ; ++d)
+			if(_holders[d] != nullptr && v.accepts[d])
+				v.byPriority[_holders[d]->priority()].insert(d);
+
+		return v;
+	}
+
+	return it->second;
+}
+
+void PreemptionIndex::insert(unsigned const dockId, Ship const * const s)
+{
+	if(dockId == 0 || dockId >= _holders.size())
+		return;
+
+	_holders[dockId] = s;
+
+	for(auto & v : _views)
+		if(v.second.accepts[dockId])
+			v.second.byPriority[s->priority()].insert(dockId);
+}
+
+void PreemptionIndex::erase(unsigned const dockId)
+{
+	if(dockId == 0 || dockId >= _holders.size()
+	|| _holders[dockId] == nullptr)
+		return;
+
+	unsigned const priority(_holders[dockId]->priority());
+
+	for(auto & v : _views)
+		if(v.second.accepts[dockId])
+			v.second.byPriority[priority].erase(dockId);
+
+	_holders[dockId] = nullptr;
+}
+
+Ship const * PreemptionIndex::candidate(Ship const * const s)
+{
+	View & v(view(s));
+
+	// Lowest priorities first (the requester's own bucket, if it holds a
+	// dock, is never reached)
+	for(auto const & bucket : v.byPriority)
+	{
+		if(bucket.first >= s->priority())
+			break;
+
+		if(!bucket.second.empty())
+			return _holders[*bucket.second.begin()];
+	}
+
+	return nullptr;
+}
@@ -23,6 +23,7 @@
 #include "../include/PrestigiousManufactory.hpp"
 
 #include "../include/Die.hpp"			// Die
+#include "../include/Config.hpp"		// Config
 #include "../include/ExpensiveEngine.hpp"	// ExpensiveEngine
 #include "../include/ExpensiveHull.hpp"		// ExpensiveHull
 #include "../include/Turbocharger.hpp"		// Turbocharger
@@ -34,20 +35,20 @@
 Engine* PrestigiousManufactory::createEngine() const
 {
 	Engine* e(nullptr);
-	unsigned result(Die::roll(1, 6));
+	unsigned result(Die::roll(Config::prestigiousEngines()));
 
 	switch(result)
 	{
-		case 6:
+		case 2:
 			e = new NuclearReactor(new ExpensiveEngine());
 		break;
 
-		case 5:
-		case 4:
+		case 1:
 			e = new Turbocharger(new ExpensiveEngine());
 		break;
 
 		default:
+		case 0:
 			e = new ExpensiveEngine();
 		break;
 	}
@@ -58,25 +59,26 @@ Engine* PrestigiousManufactory::createEngine() const
 Hull* PrestigiousManufactory::createHull() const
 {
 	Hull* h(nullptr);
-	unsigned result(Die::roll(1, 6));
+	unsigned result(Die::roll(Config::prestigiousHulls()));
 
 	switch(result)
 	{
-		case 6:
+		case 3:
 			h = new GoldPlating(
 				new TitaniumPlating(
 					new ExpensiveHull()));
 		break;
 
-		case 5:
+		case 2:
 			h = new TitaniumPlating(new ExpensiveHull());
 		break;
 
-		case 4:
+		case 1:
 			h = new GoldPlating(new ExpensiveHull());
 		break;
 
 		default:
+		case 0:
 			h = new ExpensiveHull();
 		break;
 	}
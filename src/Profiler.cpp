@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2016 Julien "Derjik" Laurent <julien.laurent@engineer.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "../include/Profiler.hpp"
+
+#include <iomanip>		// std::setw, std::setprecision
+#include <algorithm>		// std::min
+#include "../include/Flags.hpp"	// Flags
+#include "../include/Tracer.hpp"	// Tracer
+#include "../include/PerfCounters.hpp"	// PerfCounters
+#include "../include/Allocations.hpp"	// Allocations
+
+using namespace std;
+
+
+static char const * const phaseNames[PHASE_COUNT] =
+{
+	"plan", "display", "apply", "new ships", "assign", "clean exit",
+	"sleep", "cycle"
+};
+
+uint64_t Profiler::_buckets[PHASE_COUNT][PROFILER_BUCKETS];
+uint64_t Profiler::_count[PHASE_COUNT];
+uint64_t Profiler::_total[PHASE_COUNT];
+uint64_t Profiler::_max[PHASE_COUNT];
+uint64_t Profiler::_allocations[PHASE_COUNT];
+uint64_t Profiler::_allocatedBytes[PHASE_COUNT];
+uint64_t Profiler::_allocatingCalls[PHASE_COUNT];
+
+
+// Start timing (when enabled)
+ProfileScope::ProfileScope(Phase const p)
+	: _phase(p),
+	_enabled(Flags::profile() || !Flags::traceFile().empty()
+		|| Flags::zeroAllocations()),
+	_start(0), _allocations(0), _bytes(0)
+{
+	if(!_enabled)
+		return;
+
+	if(PerfCounters::available())
+		PerfCounters::read(_counters);
+	_start = Tracer::now();
+	_allocations = Allocations::count();
+	_bytes = Allocations::bytes();
+}
+
+// Stop timing, record and trace
+ProfileScope::~ProfileScope()
+{
+	uint64_t end(0), allocations(0), bytes(0);
+	uint64_t counters[PERF_COUNTER_COUNT];
+
+	if(!_enabled)
+		return;
+
+	// Read the allocations first: recording may allocate itself
+	allocations = Allocations::count() - _allocations;
+	bytes = Allocations::bytes() - _bytes;
+
+	end = Tracer::now();
+	if(PerfCounters::available())
+	{
+		PerfCounters::read(counters);
+		PerfCounters::add(_phase, _counters, counters);
+	}
+
+	Profiler::record(_phase, end - _start, allocations, bytes);
+	if(!Flags::traceFile().empty())
+		Tracer::complete(Profiler::name(_phase), "cycle", _start, end);
+}
+
+
+// Values below 2^SUB_BITS get their own bucket; above, the bucket is given
+// by the position of the highest bit and the SUB_BITS bits following it
+unsigned Profiler::bucket(uint64_t const ns)
+{
+	uint64_t v(ns);
+	unsigned shift(0);
+
+	while(v >= (2u << PROFILER_SUB_BITS))
+	{
+		v >>= 1;
+		++shift;
+	}
+
+	if(v < (1u << PROFILER_SUB_BITS))
+		return v;
+
+	return ((shift + 1) << PROFILER_SUB_BITS)
+		+ (v - (1u << PROFILER_SUB_BITS));
+}
+
+// Greatest value falling into the given bucket
+uint64_t Profiler::bucketUpperBound(unsigned const b)
+{
+	unsigned const sub(b & ((1u << PROFILER_SUB_BITS) - 1));
+	unsigned const shift(b >> PROFILER_SUB_BITS);
+
+	if(shift == 0)
+		return sub;
+
+	return ((uint64_t((1u << PROFILER_SUB_BITS) + sub + 1)) << (shift - 1))
+		- 1;
+}
+
+// Value under which the given fraction q of the samples fall
+uint64_t Profiler::percentile(Phase const p, double const q)
+{
+	uint64_t const rank(q * _count[p]);
+	uint64_t seen(0);
+
+	for(unsigned b = 0 ; b < PROFILER_BUCKETS ; ++b)
+	{
+		seen += _buckets[p][b];
+		if(seen > rank)
+			return min(bucketUpperBound(b), _max[p]);
+	}
+
+	return _max[p];
+}
+
+void Profiler::record(Phase const p, uint64_t const ns,
+		uint64_t const allocations, uint64_t const bytes)
+{
+	++_buckets[p][bucket(ns)];
+	++_count[p];
+	_total[p] += ns;
+	if(ns > _max[p])
+		_max[p] = ns;
+
+	_allocations[p] += allocations;
+	_allocatedBytes[p] += bytes;
+	if(allocations > 0 && _count[p] > PROFILER_WARMUP)
+		++_allocatingCalls[p];
+}
+
+bool Profiler::checkAllocations(ostream & out)
+{
+	bool success(true);
+
+	for(unsigned i = 0 ; i < PHASE_COUNT ; ++i)
+	{
+		Phase const p(static_cast<Phase>(i));
+
+		if(steadyState(p) && _allocatingCalls[p] > 0)
+		{
+			out << "Phase \"" << name(p) << "\" allocated during "
+			<< _allocatingCalls[p] << " of its "
+			<< _count[p] - PROFILER_WARMUP
+			<< " steady-state calls" << endl;
+			success = false;
+		}
+	}
+
+	return success;
+}
+
+char const * Profiler::name(Phase const p)
+{
+	return phaseNames[p];
+}
+
+// Print one line per phase (durations in microseconds)
+void Profiler::report(ostream & out)
+{
+	if(!Flags::profile())
+		return;
+
+	out << endl << left << setw(12) << "phase" << right
+	<< setw(10) << "count" << setw(12) << "total(ms)"
+	<< setw(10) << "p50(us)" << setw(10) << "p99(us)"
+	<< setw(10) << "max(us)" << setw(14) << "allocs/call"
+	<< setw(14) << "bytes/call" << endl;
+
+	out << fixed << setprecision(1);
+	for(unsigned i = 0 ; i < PHASE_COUNT ; ++i)
+	{
+		Phase const p(static_cast<Phase>(i));
+
+		if(_count[p] == 0)
+			continue;
+
+		out << left << setw(12) << name(p) << right
+		<< setw(10) << _count[p]
+		<< setw(12) << _total[p] / 1e6
+		<< setw(10) << percentile(p, .5) / 1e3
+		<< setw(10) << percentile(p, .99) / 1e3
+		<< setw(10) << _max[p] / 1e3
+		<< setw(14) << double(_allocations[p]) / _count[p]
+		<< setw(14) << double(_allocatedBytes[p]) / _count[p] << endl;
+	}
+	out.unsetf(ios::floatfield);
+
+	PerfCounters::report(out, _count);
+}
@@ -0,0 +1,713 @@
+/*
+ * Copyright (c) 2016 Julien "Derjik" Laurent <julien.laurent@engineer.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "../include/Renderer.hpp"
+
+#include <iostream>		// std::cout
+#include <algorithm>		// std::min, std::max, std::copy
+#include <csignal>		// signal(), raise()
+#include <unistd.h>		// write(), read(), isatty(), STDOUT_FILENO...
+#include <termios.h>		// tcgetattr(), tcsetattr()
+#include <sys/ioctl.h>		// ioctl(), TIOCGWINSZ
+#include "../include/Harbor.hpp"	// Harbor
+#include "../include/Ship.hpp"		// Ship
+#include "../include/ShipQueue.hpp"	// ShipQueue
+#include "../include/Flags.hpp"		// Flags
+#include "../include/Tracer.hpp"		// TraceScope
+
+// Symbol encoding
+#define WATER_SYMBOL	0
+#define ENTRY_SYMBOL	1
+#define DENSITY_SYMBOL	0x20000000	// | density level (1 to 3)
+#define DOCK_SYMBOL	0x40000000	// | dock ID
+#define SHIP_SYMBOL	0x80000000	// | Ship color
+
+// Screen rows used around the Harbor's surface
+#define TOP_ROWS	2	// queue line, header
+#define BOTTOM_ROWS	2	// footer, status line
+
+// Longest symbol (colored Ship), in bytes
+#define MAX_SYMBOL_BYTES	24
+
+using namespace std;
+
+
+// Terminal settings to restore on exit
+static termios originalSettings;
+static bool settingsChanged(false);
+
+// Give the terminal back in its original state
+static void restoreTerminal()
+{
+	if(settingsChanged)
+		tcsetattr(STDIN_FILENO, TCSANOW, &originalSettings);
+
+	// Show the cursor back
+	if(write(STDOUT_FILENO, "\e[?25h", 6) < 0)
+		return;
+}
+
+// Restore the terminal when interrupted, then let the signal do its job
+static void interrupted(int signal)
+{
+	restoreTerminal();
+	std::signal(signal, SIG_DFL);
+	raise(signal);
+}
+
+
+Renderer::Renderer(Harbor const * h)
+	:
+	_harbor(h),
+	_columns(h->width()),
+	_rows(h->height()),
+	_zoom(Flags::zoom()),
+	_originX(0),
+	_originY(0),
+	_fullView(true),
+	_follow(Flags::follow()),
+	_followed(nullptr),
+	_blockZoom(0),
+	_inPlace(isatty(STDOUT_FILENO) && !Flags::headless()),
+	_interactive(_inPlace && isatty(STDIN_FILENO)),
+	_firstFrame(true)
+{
+	termios settings;
+
+	// The layout never changes: draw it once (display priority: Entry
+	// point, Dock, Nothing)
+	if(!Flags::headless())
+	{
+		_layout.assign(h->width() * h->height(), WATER_SYMBOL);
+
+		for(auto dock : _harbor->reverseDockMap())
+			_layout[dock.first._y * h->width() + dock.first._x]
+				= DOCK_SYMBOL | dock.second;
+		for(Point const & entry : _harbor->entryPoints())
+			_layout[entry._y * h->width() + entry._x] = ENTRY_SYMBOL;
+	}
+
+	if(_inPlace)
+	{
+		std::signal(SIGINT, interrupted);
+		std::signal(SIGTERM, interrupted);
+	}
+
+	// Read keys as soon as they're typed, without echoing them nor
+	// waiting for them
+	if(_interactive && tcgetattr(STDIN_FILENO, &originalSettings) == 0)
+	{
+		settings = originalSettings;
+		settings.c_lflag &= ~(ICANON | ECHO);
+		settings.c_cc[VMIN] = 0;
+		settings.c_cc[VTIME] = 0;
+
+		settingsChanged =
+			(tcsetattr(STDIN_FILENO, TCSANOW, &settings) == 0);
+	}
+}
+
+Renderer::~Renderer()
+{
+	// Leave the cursor below the last frame
+	if(_inPlace && !_firstFrame)
+	{
+		_buffer += "\e[";
+		_buffer += to_string(_rows + TOP_ROWS + BOTTOM_ROWS + 1);
+		_buffer += ";1H";
+		flush();
+	}
+
+	if(_inPlace)
+	{
+		restoreTerminal();
+		settingsChanged = false;
+	}
+}
+
+// Draw a new frame
+void Renderer::display(ShipQueue const * queue)
+{
+	unsigned columns(_columns), rows(_rows);
+	bool fullView(_fullView);
+	TraceScope span("frame", "render");
+
+	if(Flags::headless())
+		return;
+
+	readKeys();
+	updateView();
+
+	// Any change in the frame's geometry requires a full redraw
+	if(_inPlace && (columns != _columns || rows != _rows
+			|| fullView != _fullView))
+		_firstFrame = true;
+
+	// Size the text buffers for the worst frame once and for all, so
+	// that a busier frame never has to grow them
+	_queueLine.reserve(_harbor->width() * MAX_SYMBOL_BYTES + 32);
+	_previousQueueLine.reserve(_queueLine.capacity());
+	_buffer.reserve((_columns + 2) * (_rows + TOP_ROWS + BOTTOM_ROWS)
+			* MAX_SYMBOL_BYTES + _queueLine.capacity());
+
+	buildQueueLine(queue);
+	buildStatusLine();
+	buildFrame();
+
+	if(!_inPlace)
+	{
+		if(!_firstFrame)
+			_buffer += "\n\n\n";
+		if(queue != nullptr)
+		{
+			_buffer += _queueLine;
+			_buffer += "\n";
+		}
+		appendFullFrame();
+	}
+	else if(_firstFrame)
+	{
+		// Hide the cursor, clear the screen and start from the top
+		_buffer += "\e[?25l\e[2J\e[H";
+		_buffer += _queueLine;
+		_buffer += "\n";
+		appendFullFrame();
+	}
+	else
+	{
+		if(_queueLine != _previousQueueLine)
+		{
+			_buffer += "\e[1;1H\e[2K";
+			_buffer += _queueLine;
+		}
+		if(_statusLine != _previousStatusLine)
+		{
+			_buffer += "\e[";
+			_buffer += to_string(_rows + TOP_ROWS + BOTTOM_ROWS);
+			_buffer += ";1H\e[2K";
+			_buffer += _statusLine;
+		}
+		appendChangedSymbols();
+	}
+
+	_frame.swap(_previousFrame);
+	_queueLine.swap(_previousQueueLine);
+	_statusLine.swap(_previousStatusLine);
+	_firstFrame = false;
+
+	flush();
+}
+
+// Apply the keys typed since the last frame
+void Renderer::readKeys()
+{
+	char keys[64];
+	ssize_t n(0);
+	int stepX(0), stepY(0);
+
+	if(!_interactive)
+		return;
+
+	// Scroll by a quarter of the viewport
+	stepX = max(1u, _columns / 4) * _zoom;
+	stepY = max(1u, _rows / 4) * _zoom;
+
+	while((n = read(STDIN_FILENO, keys, sizeof(keys))) > 0)
+	{
+		for(ssize_t i = 0 ; i < n ; ++i)
+		{
+			// Arrows come as "ESC [ A" to "ESC [ D"
+			if(keys[i] == '\e' && i + 2 < n && keys[i+1] == '[')
+			{
+				i += 2;
+				keys[i] = (keys[i] == 'A') ? 'k'
+					: (keys[i] == 'B') ? 'j'
+					: (keys[i] == 'C') ? 'l'
+					: (keys[i] == 'D') ? 'h' : keys[i];
+			}
+
+			switch(keys[i])
+			{
+				case 'h':
+					_originX -= stepX;
+					_follow = false;
+				break;
+
+				case 'l':
+					_originX += stepX;
+					_follow = false;
+				break;
+
+				case 'k':
+					_originY -= stepY;
+					_follow = false;
+				break;
+
+				case 'j':
+					_originY += stepY;
+					_follow = false;
+				break;
+
+				case '+':
+				case '=':
+					_zoom = max(1u, _zoom / 2);
+				break;
+
+				case '-':
+					_zoom = max(1u, _zoom * 2);
+				break;
+
+				case 'f':
+					_follow = !_follow;
+					_followed = nullptr;
+				break;
+
+				default:
+				break;
+			}
+		}
+	}
+}
+
+// Compute the viewport's size, zoom and position
+void Renderer::updateView()
+{
+	unsigned const width(_harbor->width()), height(_harbor->height());
+	unsigned screenColumns(width), screenRows(height);
+	winsize terminal;
+	map<Ship const *, Point>::const_iterator followedIt;
+	Point target(-1, -1);
+
+	// Available symbols: from the flags, the terminal, or unlimited
+	if(Flags::viewColumns() != 0)
+	{
+		screenColumns = Flags::viewColumns();
+		screenRows = Flags::viewRows();
+	}
+	else if(_inPlace && ioctl(STDOUT_FILENO, TIOCGWINSZ, &terminal) == 0
+		&& terminal.ws_col > 4 && terminal.ws_row > TOP_ROWS
+							+ BOTTOM_ROWS + 1)
+	{
+		// Symbols are 2 columns wide, borders take 1 column each
+		screenColumns = (terminal.ws_col - 2) / 2;
+		screenRows = terminal.ws_row - TOP_ROWS - BOTTOM_ROWS;
+	}
+
+	// Zoom out until the whole Harbor fits
+	if(_zoom == 0)
+	{
+		_zoom = 1;
+		while((width + _zoom - 1) / _zoom > screenColumns
+		|| (height + _zoom - 1) / _zoom > screenRows)
+			++_zoom;
+	}
+
+	_fullView = (_zoom == 1 && screenColumns >= width
+			&& screenRows >= height);
+
+	_columns = min(screenColumns, (width + _zoom - 1) / _zoom);
+	_rows = min(screenRows, (height + _zoom - 1) / _zoom);
+
+	if(_fullView)
+	{
+		_originX = _originY = 0;
+		return;
+	}
+
+	// Keep following the same Ship, or find a new one still on its way
+	if(_follow)
+	{
+		followedIt = _harbor->reverseSurface().find(_followed);
+		if(followedIt == _harbor->reverseSurface().end())
+		{
+			_followed = nullptr;
+			for(auto pair : _harbor->surface())
+			{
+				// Fallback: any Ship
+				if(_followed == nullptr)
+				{
+					_followed = pair.second;
+					target = pair.first;
+				}
+				// Better: a Ship which hasn't reached its dock
+				if(pair.first != _harbor->getDockPosition(
+					_harbor->getReservedDock(pair.second)))
+				{
+					_followed = pair.second;
+					target = pair.first;
+					break;
+				}
+			}
+		}
+		else
+			target = followedIt->second;
+
+		// Center it
+		if(_followed != nullptr)
+		{
+			_originX = target._x - int(_columns * _zoom) / 2;
+			_originY = target._y - int(_rows * _zoom) / 2;
+		}
+	}
+
+	// Stay within the Harbor, aligned on the density blocks
+	_originX = max(0, min(_originX, int(width) - int(_columns * _zoom)));
+	_originY = max(0, min(_originY, int(height) - int(_rows * _zoom)));
+	_originX -= _originX % _zoom;
+	_originY -= _originY % _zoom;
+}
+
+// Keep the number of Ships per block up to date (while zoomed out)
+void Renderer::updateDensities()
+{
+	unsigned const width(_harbor->width()), height(_harbor->height());
+	unsigned const blockColumns((width + _zoom - 1) / _zoom);
+	unsigned i(0);
+	bool occupied(false);
+
+	if(_zoom == 1)
+	{
+		_blockZoom = 0;
+		return;
+	}
+
+	// New zoom: count everything once
+	if(_blockZoom != _zoom)
+	{
+		_blockZoom = _zoom;
+		_occupied.assign(width * height, false);
+		_blockShips.assign(blockColumns
+				* ((height + _zoom - 1) / _zoom), 0);
+
+		for(auto pair : _harbor->surface())
+		{
+			_occupied[pair.first._y * width + pair.first._x] = true;
+			++_blockShips[(pair.first._y / _zoom) * blockColumns
+					+ pair.first._x / _zoom];
+		}
+
+		return;
+	}
+
+	// Otherwise, only look at the cells that changed
+	for(auto cell : _harbor->changedCells())
+	{
+		i = cell._y * width + cell._x;
+		occupied = (_harbor->getShipAt(cell) != nullptr);
+
+		if(occupied != _occupied[i])
+		{
+			_occupied[i] = occupied;
+			if(occupied)
+				++_blockShips[(cell._y / _zoom) * blockColumns
+						+ cell._x / _zoom];
+			else
+				--_blockShips[(cell._y / _zoom) * blockColumns
+						+ cell._x / _zoom];
+		}
+	}
+}
+
+// Displays the Ship queue state (if any) in a nice-looking way
+void Renderer::buildQueueLine(ShipQueue const * queue)
+{
+	unsigned size(0);
+
+	_queueLine.clear();
+
+	if(queue == nullptr)
+		return;
+
+	size = queue->size();
+
+	// Try displaying the Ships with their respective symbols
+	if(size <= _columns)
+	{
+		_queueLine += "[";
+
+		for(unsigned i = 0 ; i < size ; ++i)
+			queue->at(i)->display(_queueLine);
+
+		for(unsigned i = 0 ; i < _columns - size ; ++i)
+			_queueLine += "  ";
+
+		_queueLine += "]";
+	}
+	// If there are too many Ships to do so, indicate their number instead
+	else
+	{
+		_queueLine += "[ Queue size: ";
+		_queueLine += to_string(size);
+		_queueLine += " ]";
+	}
+}
+
+// Describe the viewport (if any)
+void Renderer::buildStatusLine()
+{
+	_statusLine.clear();
+
+	if(_fullView)
+		return;
+
+	_statusLine += "[";
+	_statusLine += to_string(_originX);
+	_statusLine += "-";
+	_statusLine += to_string(min(_originX + _columns * _zoom,
+					_harbor->width()) - 1);
+	_statusLine += " , ";
+	_statusLine += to_string(_originY);
+	_statusLine += "-";
+	_statusLine += to_string(min(_originY + _rows * _zoom,
+					_harbor->height()) - 1);
+	_statusLine += "] zoom ";
+	_statusLine += to_string(_zoom);
+
+	if(_follow && _followed != nullptr)
+	{
+		_statusLine += ", following ";
+		_statusLine += _followed->name();
+	}
+
+	if(_interactive)
+		_statusLine += " (arrows: scroll, +/-: zoom, f: follow)";
+}
+
+// Compute the symbols of the current frame
+void Renderer::buildFrame()
+{
+	unsigned const width(_harbor->width());
+	unsigned i(0), ships(0), blockColumns(0);
+	int y(0);
+	vector<unsigned>::const_iterator layoutIt;
+	Surface::const_iterator shipIt;
+
+	_frame.resize(_columns * _rows);
+	_ships.resize(_columns * _rows);
+
+	updateDensities();
+
+	// Zoomed out: one density level per block
+	if(_zoom > 1)
+	{
+		blockColumns = (width + _zoom - 1) / _zoom;
+
+		for(unsigned row = 0 ; row < _rows ; ++row)
+		{
+			for(unsigned column = 0 ; column < _columns ; ++column)
+			{
+				ships = _blockShips[(_originY / _zoom + row)
+					* blockColumns + _originX / _zoom
+					+ column];
+
+				// Levels 1 to 3 (0 for an empty block)
+				_frame[i++] = (ships == 0) ? WATER_SYMBOL
+					: DENSITY_SYMBOL | (1 + (3 * (ships-1))
+						/ (_zoom * _zoom));
+			}
+		}
+
+		return;
+	}
+
+	// Static layout (the visible part of each row), then the Ships above it
+	for(unsigned row = 0 ; row < _rows ; ++row)
+	{
+		layoutIt = _layout.begin() + (_originY + row) * width + _originX;
+		copy(layoutIt, layoutIt + _columns, _frame.begin() + row * _columns);
+	}
+
+	// Ships: only look at the surface's visible rows (ordered by y, x)
+	for(unsigned row = 0 ; row < _rows ; ++row)
+	{
+		y = _originY + row;
+		shipIt = _harbor->surface().lower_bound(Point(_originX, y));
+
+		while(shipIt != _harbor->surface().end()
+		&& shipIt->first._y == y
+		&& shipIt->first._x < _originX + int(_columns))
+		{
+			i = row * _columns + (shipIt->first._x - _originX);
+
+			_frame[i] = SHIP_SYMBOL | shipIt->second->color();
+			_ships[i] = shipIt->second;
+
+			++shipIt;
+		}
+	}
+}
+
+// Append the given symbol to the output buffer
+void Renderer::appendSymbol(unsigned const column, unsigned const row)
+{
+	unsigned i(row * _columns + column);
+	unsigned symbol(_frame[i]);
+	string id;
+
+	if(symbol & SHIP_SYMBOL)
+	{
+		_ships[i]->display(_buffer);
+	}
+	else if(symbol & DOCK_SYMBOL)
+	{
+		// Dock IDs are aligned on the Harbor's borders
+		id = to_string(symbol & ~DOCK_SYMBOL);
+		if(id.size() > 2)
+			// No room for the whole ID in the symbol
+			_buffer += "▐▌";
+		else
+		{
+			if(_originX + column == 0 && id.size() < 2)
+				_buffer += " ";
+			_buffer += id;
+			if(_originX + column != 0 && id.size() < 2)
+				_buffer += " ";
+		}
+	}
+	else if(symbol & DENSITY_SYMBOL)
+	{
+		switch(symbol & ~DENSITY_SYMBOL)
+		{
+			case 1:
+				_buffer += "\e[93m▒▒\e[39m";
+			break;
+
+			case 2:
+				_buffer += "\e[33m▓▓\e[39m";
+			break;
+
+			default:
+				_buffer += "\e[91m██\e[39m";
+			break;
+		}
+	}
+	else if(symbol == ENTRY_SYMBOL)
+	{
+		_buffer += "\e[38;5;94m░░\e[39m";
+	}
+	else
+	{
+		_buffer += "\e[94m░░\e[39m";
+	}
+}
+
+// Append the whole frame (UTF-8 borders included)
+void Renderer::appendFullFrame()
+{
+	// UTF-8 display header (with the entry gap in the classic layout)
+	_buffer += "┏";
+	if(_fullView)
+	{
+		for(unsigned i = 0 ; i < _columns-2 ; ++i)
+			_buffer += "━";
+		_buffer += "┛  ┗";
+		for(unsigned i = 0 ; i < _columns-2 ; ++i)
+			_buffer += "━";
+	}
+	else
+	{
+		for(unsigned i = 0 ; i < _columns ; ++i)
+			_buffer += "━━";
+	}
+	_buffer += "┓\n";
+
+	// UTF-8 display content
+	for(unsigned row = 0 ; row < _rows ; ++row)
+	{
+		_buffer += "┃";
+		for(unsigned column = 0 ; column < _columns ; ++column)
+			appendSymbol(column, row);
+		_buffer += "┃\n";
+	}
+
+	// UTF-8 display footer
+	_buffer += "┗";
+	for(unsigned i = 0 ; i < _columns ; ++i)
+		_buffer += "━━";
+	_buffer += "┛\n";
+
+	if(!_fullView)
+	{
+		_buffer += _statusLine;
+		_buffer += "\n";
+	}
+}
+
+// Append the symbols which changed since the previous frame, moving the
+// cursor only when they're not contiguous
+void Renderer::appendChangedSymbols()
+{
+	bool contiguous(false);
+	unsigned i(0);
+
+	for(unsigned row = 0 ; row < _rows ; ++row)
+	{
+		contiguous = false;
+
+		for(unsigned column = 0 ; column < _columns ; ++column, ++i)
+		{
+			if(_frame[i] == _previousFrame[i])
+			{
+				contiguous = false;
+				continue;
+			}
+
+			// Symbols are 2 columns wide, after a 1 column border
+			if(!contiguous)
+			{
+				_buffer += "\e[";
+				_buffer += to_string(row + TOP_ROWS + 1);
+				_buffer += ";";
+				_buffer += to_string(2 * column + 2);
+				_buffer += "H";
+			}
+
+			appendSymbol(column, row);
+			contiguous = true;
+		}
+	}
+}
+
+// Send the output buffer with a single system call
+void Renderer::flush()
+{
+	size_t sent(0);
+	ssize_t n(0);
+	TraceScope span("write", "render");
+
+	if(span.enabled())
+		span.arg("bytes", to_string(_buffer.size()));
+
+	// Don't overtake the standard stream
+	cout.flush();
+
+	while(sent < _buffer.size())
+	{
+		n = write(STDOUT_FILENO, _buffer.data() + sent,
+				_buffer.size() - sent);
+		if(n <= 0)
+			break;
+		sent += n;
+	}
+
+	_buffer.clear();
+}
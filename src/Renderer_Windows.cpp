@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2016 Julien "Derjik" Laurent <julien.laurent@engineer.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "../include/Renderer.hpp"
+
+#include <iostream>		// std::cout, std::endl
+#include "../include/Harbor.hpp"	// Harbor
+#include "../include/Ship.hpp"		// Ship
+#include "../include/ShipQueue.hpp"	// ShipQueue
+#include "../include/Flags.hpp"		// Flags
+#include "../include/Tracer.hpp"		// TraceScope
+
+using namespace std;
+
+
+// Windows consoles don't handle cursor addressing escape sequences: full
+// frames are drawn one after the other
+Renderer::Renderer(Harbor const * h)
+	: _harbor(h), _inPlace(false), _firstFrame(true)
+{}
+
+Renderer::~Renderer()
+{}
+
+// Draw a new frame
+void Renderer::display(ShipQueue const * queue)
+{
+	unsigned size(0);
+	TraceScope span("frame", "render");
+
+	if(Flags::headless())
+		return;
+
+	if(!_firstFrame)
+		cout << endl << endl << endl;
+
+	if(queue != nullptr)
+	{
+		size = queue->size();
+
+		// Try displaying the Ships with their respective symbols
+		if(size <= _harbor->width())
+		{
+			cout << "[";
+
+			for(unsigned i = 0 ; i < size ; ++i)
+				queue->at(i)->display();
+
+			for(unsigned i = 0 ; i < _harbor->width() - size ; ++i)
+				cout << "  ";
+
+			cout << "]";
+		}
+		// If there are too many Ships to do so, indicate their
+		// number instead
+		else
+		{
+			cout << "[ Queue size: " << size << " ]";
+		}
+
+		cout << endl;
+	}
+
+	_harbor->display();
+	_firstFrame = false;
+}
@@ -0,0 +1,251 @@
+/*
+ * Copyright (c) 2016 Julien "Derjik" Laurent <julien.laurent@engineer.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "../include/Scenario.hpp"
+
+#include <algorithm>		// std::equal
+#include <iostream>		// std::cout, std::endl
+#include "../include/Flags.hpp"	// Flags
+
+using namespace std;
+
+
+// File magic and format version
+static char const magic[] = {'H', 'B', 'S', 'C'};
+static char const version(1);
+
+ofstream Scenario::_record;
+ifstream Scenario::_replay;
+uint64_t Scenario::_checkpoints(0);
+bool Scenario::_drifted(false);
+
+
+void Scenario::open()
+{
+	char header[sizeof(magic) + 1];
+
+	if(!Flags::replayFile().empty())
+	{
+		_replay.open(Flags::replayFile(), ios::in | ios::binary);
+
+		if(!_replay.is_open())
+			cout << "Could not open replay file \""
+			<< Flags::replayFile() << "\"" << endl;
+		else if(!_replay.read(header, sizeof(header))
+		|| !equal(magic, magic + sizeof(magic), header)
+		|| header[sizeof(magic)] != version)
+		{
+			cout << "\"" << Flags::replayFile()
+			<< "\" is not a scenario file (version "
+			<< int(version) << " expected)" << endl;
+			_replay.close();
+		}
+	}
+	else if(!Flags::recordFile().empty())
+	{
+		_record.open(Flags::recordFile(),
+			ios::out | ios::trunc | ios::binary);
+
+		if(!_record.is_open())
+			cout << "Could not open record file \""
+			<< Flags::recordFile() << "\"" << endl;
+		else
+		{
+			_record.write(magic, sizeof(magic));
+			_record.put(version);
+		}
+	}
+}
+
+void Scenario::close()
+{
+	if(replaying())
+	{
+		if(!_drifted)
+		{
+			uint64_t rest(0);
+
+			// Draws or checkpoints left: the run ended early
+			if(readVarint(rest))
+				drift("run ended before the recorded one");
+			else
+				cout << "Replay matched " << _checkpoints
+				<< " cycle state hashes" << endl;
+		}
+
+		_replay.close();
+	}
+
+	if(recording())
+	{
+		_record.close();
+		cout << "Scenario recorded to " << Flags::recordFile()
+		<< " (" << _checkpoints << " cycles)" << endl;
+	}
+}
+
+void Scenario::writeVarint(uint64_t v)
+{
+	while(v >= 0x80)
+	{
+		_record.put(char((v & 0x7f) | 0x80));
+		v >>= 7;
+	}
+	_record.put(char(v));
+}
+
+bool Scenario::readVarint(uint64_t & v)
+{
+	int c(0);
+	unsigned shift(0);
+
+	v = 0;
+	do
+	{
+		c = _replay.get();
+		if(c == EOF || shift > 63)
+			return false;
+
+		v |= uint64_t(c & 0x7f) << shift;
+		shift += 7;
+	}
+	while(c & 0x80);
+
+	return true;
+}
+
+void Scenario::drift(char const * what)
+{
+	cout << "Replay diverged at cycle " << _checkpoints + 1 << ": "
+	<< what << " (draws are now rolled)" << endl;
+	_drifted = true;
+}
+
+bool Scenario::next(int64_t & value)
+{
+	uint64_t v(0);
+
+	if(!replaying() || _drifted)
+		return false;
+
+	if(!readVarint(v) || (v & 3) != INTEGER)
+	{
+		drift("integer draw expected");
+		return false;
+	}
+
+	// Undo the zigzag encoding
+	v >>= 2;
+	value = int64_t(v >> 1) ^ -int64_t(v & 1);
+	return true;
+}
+
+bool Scenario::next(float & value)
+{
+	uint64_t v(0);
+
+	if(!replaying() || _drifted)
+		return false;
+
+	if(!readVarint(v) || v != REAL
+	|| !_replay.read(reinterpret_cast<char *>(&value), sizeof(value)))
+	{
+		drift("floating point draw expected");
+		return false;
+	}
+
+	return true;
+}
+
+bool Scenario::next(int64_t & value, int64_t const min, int64_t const max)
+{
+	if(!next(value))
+		return false;
+
+	if(value < min || value > max)
+	{
+		drift("integer draw out of range");
+		return false;
+	}
+
+	return true;
+}
+
+bool Scenario::next(float & value, float const min, float const max)
+{
+	if(!next(value))
+		return false;
+
+	if(!(value >= min && value <= max))
+	{
+		drift("floating point draw out of range");
+		return false;
+	}
+
+	return true;
+}
+
+void Scenario::record(int64_t const value)
+{
+	// Zigzag encoding: small negative values stay small
+	if(recording())
+		writeVarint(((uint64_t(value) << 1) ^ uint64_t(value >> 63)) << 2
+				| INTEGER);
+}
+
+void Scenario::record(float const value)
+{
+	if(recording())
+	{
+		writeVarint(REAL);
+		_record.write(reinterpret_cast<char const *>(&value),
+				sizeof(value));
+	}
+}
+
+void Scenario::checkpoint(uint64_t const hash)
+{
+	uint64_t v(0), recorded(0);
+
+	if(recording())
+	{
+		writeVarint(CHECKPOINT);
+		_record.write(reinterpret_cast<char const *>(&hash),
+				sizeof(hash));
+	}
+	else if(!replaying() || _drifted)
+		return;
+	else if(!readVarint(v) || v != CHECKPOINT
+	|| !_replay.read(reinterpret_cast<char *>(&recorded),
+			sizeof(recorded)))
+	{
+		drift("end of cycle expected");
+		return;
+	}
+	else if(hash != recorded)
+	{
+		drift("state hash mismatch");
+		return;
+	}
+
+	++_checkpoints;
+}
@@ -22,37 +22,42 @@
 
 #include "../include/Ship.hpp"
 
-#include <sstream>			// std::ostringstream
+#include <string>			// std::to_string
 #include "../include/Factory.hpp"	// Factory
 #include "../include/Engine.hpp"	// Engine
 #include "../include/Hull.hpp"		// Hull
+#include "../include/Die.hpp"		// Die
 
 using namespace std;
 
 
+unsigned long Ship::_serial(0);
+unsigned Ship::_census[STATE_COUNT] = {0};
+
+
 Ship::Ship(Factory const * const f, string const name)
 	:
 	_name(name),
 	_engine(f->createEngine()),
 	_hull(f->createHull()),
+	_stepsBeforeFailure(0),
+	_failureRolled(false),
+	_state(ENTERING),
 	_LinuxColor(240),
 	_WindowsColor(7)
 {
+	// Default names are serial numbers: unique, and identical from one
+	// run of a scenario to the next (unlike addresses)
 	if(_name == "")
-	{
-		// This is the best (or least worst, at least)
-		// workaround we've found to generate guenuinely
-		// unique Ship names.
-		ostringstream o;
-		// In fact, we cast its address into a string.
-		const void * p(static_cast<const void*>(this));
-		o << p;
-		_name = o.str();
-	}
+		_name = "#" + to_string(++_serial);
+
+	++_census[_state];
 }
 
 Ship::~Ship()
 {
+	--_census[_state];
+
 	delete _engine;
 	delete _hull;
 }
@@ -67,6 +72,46 @@ Hull const * Ship::hull() const
 	return _hull;
 }
 
+// Rather than rolling one Bernoulli trial per step, count down the steps
+// separating two failures: the gap between two failures of probability p
+// follows a geometric distribution, which makes both processes identical.
+bool Ship::engineFails() const
+{
+	// Draw the distance to the next failure
+	if(!_failureRolled)
+	{
+		_stepsBeforeFailure = Die::rollGeometric(failureProbability());
+		_failureRolled = true;
+	}
+
+	if(_stepsBeforeFailure > 0)
+	{
+		--_stepsBeforeFailure;
+		return false;
+	}
+
+	// Failure: the next gap will be drawn on the next step
+	_failureRolled = false;
+	return true;
+}
+
+ShipState Ship::state() const
+{
+	return _state;
+}
+
+void Ship::setState(ShipState const s) const
+{
+	--_census[_state];
+	++_census[s];
+	_state = s;
+}
+
+unsigned Ship::count(ShipState const s)
+{
+	return _census[s];
+}
+
 string Ship::name() const
 {
 	return _name;
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2016 Julien "Derjik" Laurent <julien.laurent@engineer.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "../include/ShipQueue.hpp"
+
+#include <algorithm>		// std::push_heap, std::pop_heap, std::min
+#include "../include/Ship.hpp"	// Ship
+
+using namespace std;
+
+
+void ShipQueue::push(Ship const * const s, uint64_t const cycle)
+{
+	_heap.push_back({s->priority() - _aging * double(cycle), _pushed++, s});
+	push_heap(_heap.begin(), _heap.end(), after);
+}
+
+Ship const * ShipQueue::pop()
+{
+	pop_heap(_heap.begin(), _heap.end(), after);
+
+	Ship const * const s(_heap.back().ship);
+	_heap.pop_back();
+	return s;
+}
+
+// Best-first walk of the heap: the next Ship to serve is the best entry of
+// a frontier which starts at the root, and every entry taken from it hands
+// its children over (the frontier never holds more than k + 1 entries)
+void ShipQueue::next(unsigned const k, vector<Ship const *> & out)
+{
+	auto const later([this](unsigned const a, unsigned const b)
+	{
+		return after(_heap[a], _heap[b]);
+	});
+
+	_frontier.clear();
+	if(!_heap.empty())
+		_frontier.push_back(0);
+
+	for(unsigned n = 0 ; n < k && !_frontier.empty() ; ++n)
+	{
+		pop_heap(_frontier.begin(), _frontier.end(), later);
+
+		unsigned const i(_frontier.back());
+		unsigned const end(min<unsigned>(2 * i + 3, _heap.size()));
+
+		_frontier.pop_back();
+		out.push_back(_heap[i].ship);
+
+		// Children
+		for(unsigned c = 2 * i + 1 ; c < end ; ++c)
+		{
+			_frontier.push_back(c);
+			push_heap(_frontier.begin(), _frontier.end(), later);
+		}
+	}
+}
@@ -31,3 +31,15 @@ void Ship::display() const
 {
 	cout << "\e[38;5;" << _LinuxColor << "m◀▶\e[39m";
 }
+
+void Ship::display(string & frame) const
+{
+	frame += "\e[38;5;";
+	frame += to_string(_LinuxColor);
+	frame += "m◀▶\e[39m";
+}
+
+unsigned Ship::color() const
+{
+	return _LinuxColor;
+}
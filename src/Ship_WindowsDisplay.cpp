@@ -46,3 +46,14 @@ void Ship::display() const
 	cout << "<>";
 	SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 7);
 }
+
+// Note: console colors can't be embedded in a string buffer
+void Ship::display(string & frame) const
+{
+	frame += "<>";
+}
+
+unsigned Ship::color() const
+{
+	return _WindowsColor;
+}
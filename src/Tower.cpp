@@ -25,18 +25,30 @@
 #include <thread>	// std::this_thread::sleep_for
 #include <chrono>	// std::chrono
 
-#include <iostream>	// std::cout
 #include <cstdlib>	// abs()
+#include <climits>	// UINT_MAX
+#include <algorithm>	// std::sort, std::unique, std::remove_if, std::find_if,
+			// std::min
 
 /* Harbor */
 #include "../include/Harbor.hpp"
 
+/* Routing */
+#include "../include/Route.hpp"
+#include "../include/ClusterMap.hpp"
+
+/* Arrivals */
+#include "../include/ArrivalProcess.hpp"
+
 /* Ships */
 #include "../include/PassengerShip.hpp"
 #include "../include/MilitaryShip.hpp"
 #include "../include/FishingBoat.hpp"
 #include "../include/PleasureCraft.hpp"
 
+/* Hulls */
+#include "../include/Hull.hpp"
+
 /* Factories */
 #include "../include/LowCostManufactory.hpp"
 #include "../include/PrestigiousManufactory.hpp"
@@ -44,122 +56,433 @@
 /* Flags */
 #include "../include/Flags.hpp"
 
-/* Die */
+/* Die & probability tables */
 #include "../include/Die.hpp"
+#include "../include/Config.hpp"
+
+/* Metrics & profiling */
+#include "../include/Metrics.hpp"
+#include "../include/Profiler.hpp"
+#include "../include/Tracer.hpp"
+#include "../include/Scenario.hpp"
 
 using namespace std;
 
 
 // Initialize logfiles and set the Harbor instance pointer
 Tower::Tower(Harbor * h)
-	: _log("Tower.log"), _xml("ships.xml"), _harbor(h)
-{}
+	: _log("Tower.log"), _xml("ships.xml"),
+	_shipQueue(Flags::queueAging()), _harbor(h), _arrivals(nullptr),
+	_cycle(0), _clusters(nullptr), _dockings(0), _stalledCycles(0),
+	_livelocked(false), _renderer(h)
+{
+	unsigned const docks(h->dockMap().size());
+
+	// Size the batch assignment buffers once and for all
+	if(Flags::dockBatchPeriod() > 0)
+	{
+		_matcher.reserve(DOCK_BATCH_SIZE, docks);
+		_batchShips.reserve(DOCK_BATCH_SIZE);
+		_batchOrigins.reserve(DOCK_BATCH_SIZE);
+		_batchDocks.reserve(docks);
+		_batchDockPositions.reserve(docks);
+		_batchChanges.reserve(DOCK_BATCH_SIZE);
+		_shipQueue.reserveNext(DOCK_BATCH_SIZE);
+	}
+
+	// Every Ship on the surface holds a dock: it has one pending event at
+	// most, plus those of the Ships deleted during the last cycle
+	if(Flags::events())
+	{
+		_events.reserve(2 * docks + 1);
+		_due.reserve(2 * docks);
+	}
+	else
+		_active.reserve(2 * docks);
+
+	// Wait-for graph buffers (a wait per Ship on the surface at most)
+	_blockers.reserve(2 * docks);
+	_waits.reserve(2 * docks);
+	_lastWaits.reserve(2 * docks);
+	_brokenWaits.reserve(2 * docks);
+	_ring.reserve(docks);
+	_backOffs.reserve(docks);
+	_swaps.reserve(2);
+
+	// Evacuation buffers
+	_evacuees.reserve(2 * docks);
+	_occupied.assign(h->width() * h->height(), false);
+	_exitLoads.assign(h->entryPoints().size(), 0);
+
+	if(Flags::routing() != STRAIGHT)
+	{
+		_routes.reserve(2 * docks);
+		_spareRoutes.reserve(2 * docks);
+	}
+	if(Flags::routing() == HPA)
+		_clusters = new ClusterMap(h);
+}
+
+Tower::~Tower()
+{
+	delete _arrivals;
+
+	for(auto const & r : _routes)
+		delete r.second;
+	for(Route * r : _spareRoutes)
+		delete r;
+
+	delete _clusters;
+
+	// Clean the Ships still waiting to enter the Harbor
+	while(!_shipQueue.empty())
+		delete _shipQueue.pop();
+}
 
 
 // Start a cycle using the given Ship creation probability
 // (proba should be a number between 0 and 100 inclusive,
 // 0 meaning "no ships", 100 meaning "a new Ship each turn")
+// unless another arrival process is selected (see Flags)
 void Tower::cycle(unsigned const proba)
 {
 	bool allDestinationsReached = false;
+	bool live(true);
+	unsigned cycles(0);
+
+	delete _arrivals;
+	_arrivals = ArrivalProcess::create(proba);
 
 
 	// Initial Harbor display
-	_harbor->display();
+	_renderer.display();
+	_harbor->clearChangedCells();
+
+	// Ships placed onto the surface beforehand join the planning
+	for(auto const & cell : _harbor->surface())
+		if(cell.second->state() == ENTERING)
+			activate(cell.second);
+	if(_clusters != nullptr)
+		_clusters->reset();
+	reserveRoutes();
+
+	// Event-driven alternative
+	if(Flags::events())
+	{
+		runEvents();
+		return;
+	}
 
 	// As long as docks are available from the Harbor OR some Ships
-	// need to move
-	while(!_harbor->availableDocks().empty() || !allDestinationsReached)
+	// need to move (unless the cycles limit is reached)
+	// (unless the watchdog gave up on a livelock)
+	while(live
+	&& (!_harbor->availableDocks().empty() || !allDestinationsReached)
+	&& (Flags::maxCycles() == 0 || cycles++ < Flags::maxCycles()))
 	{
+		ProfileScope cycleScope(CYCLE);
+		++_cycle;
+
 		// Temporization
-		sleep(Flags::cycleDelay());
+		{
+			ProfileScope scope(SLEEP);
+			sleep(Flags::cycleDelay());
+		}
 
 		// Plan movements on the whole surface
-		allDestinationsReached = planMovements();
+		{
+			ProfileScope scope(PLAN);
+			allDestinationsReached = planMovements();
+		}
 
 		// Display the Ship queue and Harbor's surface
-		cout << endl << endl << endl;
-		displayQueue();
-		_harbor->display();
+		// (changed cells are tracked from one frame to the next)
+		{
+			ProfileScope scope(DISPLAY);
+			_renderer.display(&_shipQueue);
+			_harbor->clearChangedCells();
+		}
 
-		// Apply the planned moves onto the surface
-		applyPlannedMovements();
+		// Apply the planned moves onto the surface, then break the
+		// deadlocks they revealed
+		{
+			ProfileScope scope(APPLY);
+			applyPlannedMovements();
+
+			resolveWaits();
+			live = watch(Ship::count(ROUTING)
+					+ Ship::count(BLOCKED) == 0);
+		}
 
 		// Prepare new Ships arrival
-		manageNewShips(proba);
+		{
+			ProfileScope scope(NEW_SHIPS);
+			manageNewShips(_arrivals->arrivals());
+		}
+
+		// Periodically optimize the docks' assignment
+		if(Flags::dockBatchPeriod() > 0
+		&& _cycle % Flags::dockBatchPeriod() == 0)
+		{
+			ProfileScope scope(ASSIGN);
+			batchAssignDocks();
+		}
+
+		// Sample the cycle's metrics
+		sampleMetrics();
+
+		// Record or check the cycle's state (scenario replays)
+		if(Scenario::active())
+			Scenario::checkpoint(_harbor->stateHash());
 	}
 }
 
-// Start the "reverse" cycle: this one causes all Ships
-// emplaced in the Harbor to seek for the closest exit
-// and disappear until they're all gone.
-void Tower::cycleOut()
+// Discrete-event version of the cycle() loop: a cycle only runs when
+// some event is due and only handles the Ships concerned (travelling Ships
+// move each cycle, docked ones are left alone), idle cycles being skipped
+// as long as no Ship arrives (see scheduleArrival). Within a cycle,
+// events are handled in the order of cycle()'s steps, so that both loops
+// draw the same random numbers and lead to the same Harbor.
+void Tower::runEvents()
 {
-	Ship const * currentShip(nullptr);
+	uint64_t const last(Flags::maxCycles() == 0 ? UINT64_MAX
+				: _cycle + Flags::maxCycles());
+	bool live(true), idle(false), reached(false);
+	unsigned count(0);
+	Event e;
 
-	// While Ships are present in the Harbor
-	while(_harbor->surface().size() > 0)
+	_events.push({_cycle + 1, ARRIVAL, nullptr, 0});
+
+	while(live)
 	{
+		// Skipped cycles (nothing moves, nobody arrives: blocked Ships
+		// stall) until one brings Ships. Their arrivals are drawn one
+		// cycle at a time, after the previous cycle's checkpoint, as
+		// cycle() draws them (both loops record the same scenario)
+		while(live && idle && _cycle < last)
+			if((count = _arrivals->arrivals()) > 0)
+			{
+				_events.push({_cycle + 1, ARRIVAL, nullptr, count});
+				idle = false;
+			}
+			else
+			{
+				++_cycle;
+				Metrics::observe(CYCLE_MOVES, 0);
+				live = watch(Ship::count(BLOCKED) == 0);
+				sampleMetrics();
+
+				if(Scenario::active())
+					Scenario::checkpoint(
+						_harbor->stateHash());
+			}
+
+		if(!live || _events.empty() || _events.top().cycle > last)
+			break;
+
+		ProfileScope cycleScope(CYCLE);
+		++_cycle;
+
 		// Temporization
-		sleep(Flags::cycleDelay());
+		{
+			ProfileScope scope(SLEEP);
+			sleep(Flags::cycleDelay());
+		}
 
-		// Get a Ship to move out
-		if(currentShip == nullptr)
-			currentShip = _harbor->surface().begin()->second;
+		// Plan the movements of the Ships due to move (in the
+		// surface's order, as planMovements() does)
+		{
+			ProfileScope scope(PLAN);
 
-		// Plan outgoing movements on the whole surface
-		manageOutgoingShip(currentShip);
+			_due.clear();
+			while(!_events.empty() && _events.top().cycle == _cycle
+			&& _events.top().type == MOVE)
+				_due.push_back(_events.pop().ship);
 
-		// Display the Harbor's surface
-		cout << endl << endl << endl;
-		_harbor->display();
+			prepare(_due);
+			repairRoutes();
 
-		// Clean the exit Points
-		cleanExit();
+			reached = true;
+			for(Ship const * s : _due)
+				reached &= !planMovement(
+					_harbor->getShipPosition(s), s);
+			reached = reached && Ship::count(BLOCKED) == 0;
+		}
 
-		// Detect eventual Ship deletion
-		if(_harbor->reverseSurface().find(currentShip)
-				== _harbor->reverseSurface().end())
-			currentShip = nullptr;
+		// Display the Ship queue and Harbor's surface
+		{
+			ProfileScope scope(DISPLAY);
+			_renderer.display(&_shipQueue);
+			_harbor->clearChangedCells();
+		}
 
-		// Apply the planned moves onto the surface
-		applyPlannedMovements();
-	}
+		// Apply the planned moves, then schedule what comes next for
+		// the Ships which survived them and break the deadlocks the
+		// moves revealed
+		{
+			ProfileScope scope(APPLY);
+			applyPlannedMovements();
+
+			for(Ship const * s : _due)
+				if(_harbor->reverseSurface().count(s) > 0)
+					scheduleShip(s);
+
+			resolveWaits();
+			live = watch(Ship::count(ROUTING)
+					+ Ship::count(BLOCKED) == 0);
+
+			while(!_events.empty() && _events.top().cycle == _cycle
+			&& _events.top().type == DOCKING)
+			{
+				e = _events.pop();
+
+				if(_harbor->reverseSurface().count(e.ship) > 0)
+					_log << info << "Ship " << e.ship->name()
+					<< " reached dock n°"
+					<< _harbor->getReservedDock(e.ship) << endl;
+			}
+		}
+
+		// New Ships arrival, then wake the Ships concerned by the
+		// cycle's changes before looking for the next arrivals
+		{
+			ProfileScope scope(NEW_SHIPS);
+			bool const arrival(!_events.empty()
+					&& _events.top().cycle == _cycle
+					&& _events.top().type == ARRIVAL);
+
+			if(arrival)
+			{
+				e = _events.pop();
+				manageNewShips(e.count > 0 ? e.count
+							: _arrivals->arrivals());
+			}
+
+			wakeShips();
+
+			if(arrival)
+				idle = scheduleArrival();
+		}
+
+		// Periodically optimize the docks' assignment
+		if(Flags::dockBatchPeriod() > 0
+		&& _cycle % Flags::dockBatchPeriod() == 0)
+		{
+			ProfileScope scope(ASSIGN);
+			batchAssignDocks();
+		}
+
+		// Sample the cycle's metrics
+		sampleMetrics();
+
+		// Record or check the cycle's state (scenario replays)
+		if(Scenario::active())
+			Scenario::checkpoint(_harbor->stateHash());
 
-	cout << endl << endl << endl;
-	_harbor->display();
+		// cycle()'s end: no dock left, while the cycle's planning
+		// found every Ship on its dock (even if some arrived since)
+		if(reached && _harbor->availableDocks().empty())
+			break;
+	}
 }
 
-// Displays the Ship queue state in a nice-looking
-// and OS-compatible way
-void Tower::displayQueue()
+// Schedule what comes next for the given (just planned) Ship in runEvents()
+// (blocked Ships wait for wakeShips)
+void Tower::scheduleShip(Ship const * const s)
 {
-	unsigned size(_shipQueue.size());
+	if(s->state() == DOCKED)
+		_events.push({_cycle, DOCKING, s, 0});
+	else if(s->state() == ROUTING)
+		_events.push({_cycle + 1, MOVE, s, 0});
+}
 
-	// Try displaying the Ships with their respective symbols
-	if(size <= _harbor->width())
+// Schedule the next arrivals of runEvents(): returns true if the Harbor
+// is idle with docks left, the next cycles then being skipped until one
+// brings Ships
+bool Tower::scheduleArrival()
+{
+	// Ships are moving or waiting (or blocked, while a batch assignment
+	// may give them new docks): the next cycle runs anyway
+	if((!_events.empty() && _events.top().cycle == _cycle + 1)
+	|| !_shipQueue.empty()
+	|| (Flags::dockBatchPeriod() > 0 && Ship::count(BLOCKED) > 0))
 	{
-		cout << "[";
+		_events.push({_cycle + 1, ARRIVAL, nullptr, 0});
+		return false;
+	}
+
+	// Otherwise, unless the Harbor is full and still (the loop ends)
+	return !_harbor->availableDocks().empty();
+}
 
-		for(auto ship : _shipQueue)
-			ship->display();
+// Start the "reverse" cycle: this one causes all Ships
+// emplaced in the Harbor to seek for an exit (all at once,
+// see planEvacuation) and disappear until they're all gone.
+void Tower::cycleOut()
+{
+	unsigned cycles(0);
+	bool live(true);
 
-		for(unsigned i = 0 ; i < _harbor->width() - size ; ++i)
-			cout << "  ";
+	_stalledCycles = 0;
 
-		cout << "]";
-	}
-	// If there are too many Ships to do so, indicate their number instead
-	else
+	// While Ships are present in the Harbor
+	// (unless the cycles limit is reached or the watchdog gave up)
+	while(live && _harbor->surface().size() > 0
+	&& (Flags::maxCycles() == 0 || cycles++ < Flags::maxCycles()))
 	{
-		cout << "[ Queue size: " << _shipQueue.size() << " ]";
+		ProfileScope cycleScope(CYCLE);
+		++_cycle;
+
+		// Temporization
+		{
+			ProfileScope scope(SLEEP);
+			sleep(Flags::cycleDelay());
+		}
+
+		// Plan outgoing movements on the whole surface
+		{
+			ProfileScope scope(PLAN);
+			planEvacuation();
+		}
+
+		// Display the Harbor's surface
+		{
+			ProfileScope scope(DISPLAY);
+			_renderer.display();
+			_harbor->clearChangedCells();
+		}
+
+		// Clean the exit Points (Ships leaving make progress)
+		{
+			ProfileScope scope(CLEAN_EXIT);
+			size_t const ships(_harbor->surface().size());
+
+			cleanExit();
+			live = watch(_harbor->surface().size() < ships);
+		}
+
+		// Apply the planned moves onto the surface
+		{
+			ProfileScope scope(APPLY);
+			applyPlannedMovements();
+		}
+
+		// Sample the cycle's metrics
+		sampleMetrics();
+
+		// Record or check the cycle's state (scenario replays)
+		if(Scenario::active())
+			Scenario::checkpoint(_harbor->stateHash());
 	}
 
-	cout << endl;
+	_renderer.display();
+	_harbor->clearChangedCells();
 }
 
 // Computes one movement for one Ship and returns true if the Ship will move
-bool Tower::traceRoute(Point const & source, Point const & dest)
+// (blocked, if given, tells whether an obstacle kept it from moving at all)
+bool Tower::traceRoute(Point const & source, Point const & dest,
+			bool * const blocked)
 {
 	// Ships
 	Ship const	*ourShip(_harbor->getShipAt(source)),
@@ -169,9 +492,9 @@ bool Tower::traceRoute(Point const & source, Point const & dest)
 	unsigned movesToGo(ourShip->speed());
 	Point currentLocation(source);
 	Direction direction;
+	bool stayedPut(false);
 
-	// Aleas
-	float fail;
+	TraceScope span("traceRoute", "route");
 
 	// If we're already on the destination Point
 	if(source == dest)
@@ -186,37 +509,57 @@ bool Tower::traceRoute(Point const & source, Point const & dest)
 		return false;
 	}
 
+	if(span.enabled())
+		span.arg("ship", ourShip->name());
+
+	// Route search, moved to the route's start
+	Route * search(nullptr);
+	if(Flags::routing() != STRAIGHT)
+	{
+		search = route(ourShip, dest);
+		search->plan(source);
+	}
+
 	_log << info << "Roadmap for Ship " << ourShip->name() << ":" << endl;
 
 	while(movesToGo > 0 && currentLocation != dest)
 	{
 		// Compute delta between current location and given destination
+		// (or follow the search's route, if any)
 		direction = Direction(dest - currentLocation);
+		if(search == nullptr && Flags::congestion() > 0.f)
+			direction = steer(currentLocation, dest);
+		else if(search != nullptr)
+		{
+			Point const next(search->next(currentLocation, direction));
+
+			if(next != currentLocation)
+				direction = Direction(next - currentLocation);
+		}
 
 		// Look for obstacles
 		otherShip = _harbor->getShipAt(currentLocation + direction);
 
-		fail = Die::roll(0.f, 1.f);
-
 		// If the engine failes
-		if(fail < ourShip->failureProbability())
+		if(ourShip->engineFails())
 		{
 			_log << info << "\t"
 			<< ourShip->speed() - movesToGo + 1
 			<< ": [Engine failure] " << currentLocation << endl;
+			Metrics::increment(ENGINE_FAILURES);
 		}
 		// If there's no ostacle OR if we can easily crush it
 		// into pieces
 		else if(otherShip == nullptr
-			|| otherShip->hull() <= ourShip->hull())
+			|| (*otherShip->hull()) <= (*ourShip->hull()))
 		{
 			_log << info << "\t"
 			<< ourShip->speed() - movesToGo + 1 << ": "
 			<< currentLocation << " -> "
 			<< currentLocation + direction << endl;
 
-			_plannedMovements.push_back(make_pair(currentLocation,
-						currentLocation + direction));
+			_plannedMovements.push_back({ourShip, currentLocation,
+						currentLocation + direction});
 			currentLocation += direction;
 		}
 		// Assume no movement is possible at the time
@@ -225,32 +568,25 @@ bool Tower::traceRoute(Point const & source, Point const & dest)
 			_log << info << "\t"
 			<< ourShip->speed() - movesToGo + 1
 			<< ": [Stay put] " << currentLocation << endl;
+			Metrics::increment(STAY_PUTS);
+
+			if(!stayedPut)
+				wait(ourShip, otherShip);
+			stayedPut = true;
 		}
 		--movesToGo;
 	}
 
+	if(blocked != nullptr)
+		*blocked = stayedPut && currentLocation == source;
+
 	return true;
 }
 
 // Find the nearest exit Point to a given source Point
 Point Tower::chooseExit(Point const & source)
 {
-	// Initial distance
-	unsigned dist(manhattanDistance(source, (*_harbor->entryPoints().begin())));
-	// Default chosen exit
-	Point chosenExit((*_harbor->entryPoints().begin()));
-
-	// Probe available exit points to find the closest one
-	for(auto entryPoint : _harbor->entryPoints())
-	{
-		if(manhattanDistance(source, entryPoint) < dist)
-		{
-			dist = manhattanDistance(source, entryPoint);
-			chosenExit = entryPoint;
-		}
-	}
-
-	return chosenExit;
+	return _harbor->exitMap().exit(source);
 }
 
 void Tower::cleanExit()
@@ -265,131 +601,841 @@ void Tower::cleanExit()
 		{
 			_harbor->removeShip(exit);
 			delete s;
+			Metrics::increment(SHIPS_DEPARTED);
 		}
 	}
 }
 
-// Plan outgoing movements and remove Ships that reached
-// an exit Point
-void Tower::manageOutgoingShip(Ship const * ship)
+// Plan the moves of every Ship towards an exit at once. The Ships are
+// spread over the exits, nearest first: each heads for the exit it would
+// leave by the earliest, counting the Ships already sent there (one leaves
+// per exit and cycle). Nothing holds a Ship back: they then move one step
+// at a time in that order, each into a cell left free by the moves planned
+// so far, so that the queues behind each exit close up within the cycle
+// and no Ship crushes another on its way out.
+void Tower::planEvacuation()
 {
-	Point source(-1, -1), dest(-1, -1);
+	unsigned const width(_harbor->width());
+	unsigned steps(0), rank(0), departure(0), best(0), speed(0);
+
+	_evacuees.clear();
+
+	// The Ships already on an exit leave before the moves (see cleanExit)
+	for(auto const & cell : _harbor->surface())
+		if(_harbor->entryPoints().count(cell.first) == 0)
+		{
+			cell.second->setState(LEAVING);
+			_evacuees.push_back({cell.second, cell.first,
+				chooseExit(cell.first),
+				_harbor->exitMap().distance(cell.first), 0});
+			_occupied[cell.first.x() + cell.first.y() * width] = true;
+			steps = max(steps, cell.second->speed());
+		}
+
+	// Nearest first (in the surface's order otherwise)
+	sort(_evacuees.begin(), _evacuees.end(),
+		[](Evacuee const & a, Evacuee const & b)
+		{
+			return a.distance < b.distance
+				|| (a.distance == b.distance
+				&& a.position < b.position);
+		});
+
+	// Exits load balancing: earliest departure, given the Ship's speed
+	fill(_exitLoads.begin(), _exitLoads.end(), 0);
+	for(Evacuee & e : _evacuees)
+	{
+		speed = max(e.ship->speed(), 1u);
+		best = UINT_MAX;
+		rank = 0;
+
+		for(Point const & exit : _harbor->entryPoints())
+		{
+			departure = max((manhattanDistance(e.position, exit)
+					+ speed - 1) / speed, _exitLoads[rank]);
+
+			if(departure < best)
+			{
+				best = departure;
+				e.exit = exit;
+				e.rank = rank;
+			}
+			++rank;
+		}
 
-	if(ship == nullptr)
+		_exitLoads[e.rank] = best + 1;
+	}
+
+	// Steps, in turns
+	for(unsigned step = 0 ; step < steps ; ++step)
+		for(Evacuee & e : _evacuees)
+			if(step < e.ship->speed() && e.position != e.exit)
+				stepOut(e);
+
+	// Leave the occupation grid clear for the next cycle
+	for(Evacuee const & e : _evacuees)
+		_occupied[e.position.x() + e.position.y() * width] = false;
+}
+
+// Plan one step of the given Ship to its exit, into a cell free at this
+// point of the planning: down the exit map when heading to the nearest
+// exit, else along the largest delta or the other one
+void Tower::stepOut(Evacuee & e)
+{
+	unsigned const width(_harbor->width());
+	Point const delta(e.exit - e.position);
+	Direction const first(delta);
+	Direction second(first);
+	Point candidates[2];
+	unsigned n(0);
+
+	if(e.ship->engineFails())
+	{
+		_log << info << "Ship " << e.ship->name() << ": [Engine failure] "
+		<< e.position << endl;
+		Metrics::increment(ENGINE_FAILURES);
 		return;
+	}
+
+	if(chooseExit(e.position) == e.exit)
+		n = _harbor->exitMap().downhill(e.position, candidates);
+	else
+	{
+		if((first == LEFT || first == RIGHT) && delta.y() != 0)
+			second = delta.y() > 0 ? DOWN : UP;
+		else if((first == UP || first == DOWN) && delta.x() != 0)
+			second = delta.x() > 0 ? RIGHT : LEFT;
+
+		candidates[n++] = e.position + first;
+		if(second != first)
+			candidates[n++] = e.position + second;
+	}
 
-	// Get the Ships current position
-	map<Ship const *, Point>::const_iterator
-		pair(_harbor->reverseSurface().find(ship));
+	while(n > 0 && _occupied[candidates[0].x()
+				+ candidates[0].y() * width])
+	{
+		candidates[0] = candidates[1];
+		--n;
+	}
+
+	if(n == 0)
+	{
+		_log << info << "Ship " << e.ship->name() << ": [Stay put] "
+		<< e.position << endl;
+		Metrics::increment(STAY_PUTS);
+		return;
+	}
 
-	// Source is the Ships current position
-	source = pair->second;
+	Point const target(candidates[0]);
 
-	// Choose the nearest exit
-	dest = chooseExit(source);
+	_log << info << "Ship " << e.ship->name() << ": " << e.position
+	<< " -> " << target << endl;
 
-	// Compute a route to the chosen exit
-	traceRoute(source, dest);
+	_plannedMovements.push_back({e.ship, e.position, target});
+	_occupied[e.position.x() + e.position.y() * width] = false;
+	_occupied[target.x() + target.y() * width] = true;
+	e.position = target;
 }
 
-// Computes the planned movements for each Ship onto the Harbor's surface
+// Computes the planned movements of the active Ships: docked and blocked
+// Ships are left alone until something changes around them (see
+// wakeShips), so that planning only costs as much as the traffic
 bool Tower::planMovements()
 {
-	// Currently manipulated dock ID
-	unsigned dockId(0);
+	// True when every Ship on the surface has reached its destination
+	bool allDestinationsReached(true);
 
-		// True when every Ship on the surface has reached
-		// its destination
-	bool 	allDestinationsReached(true),
-		// True if a movement is needed
-		// (determined turn by turn with traceRoute)
-		movementNeeded(false);
+	wakeShips();
+	prepare(_active);
+	repairRoutes();
+
+	for(Ship const * s : _active)
+		allDestinationsReached &= !planMovement(
+					_harbor->getShipPosition(s), s);
+
+	// Only the travelling Ships remain active
+	_active.erase(remove_if(_active.begin(), _active.end(),
+		[](Ship const * s) { return s->state() != ROUTING; }),
+		_active.end());
+
+	// Blocked Ships haven't reached their destination either
+	return allDestinationsReached && Ship::count(BLOCKED) == 0;
+}
+
+// Computes the planned movements of one Ship (located at source) and
+// returns true if a movement is needed
+bool Tower::planMovement(Point const & source, Ship const * const s)
+{
+	// Its reserved dock ID
+	unsigned dockId(_harbor->getReservedDock(s));
 
-	// Current Ship's source and destination
-	Point source(-1,-1), dest(-1, -1);
+	// Its destination
+	Point dest(-1, -1);
 
-	// For each Ship currently emplaced onto the Harbor...
-	for(auto pair : _harbor->surface())
+	// If it has an assigned dock (which it SHOULD REALLY have)
+	if(dockId != 0)
 	{
-		// Get its current position
-		// and its reserved dock ID
-		source = pair.first;
-		dockId = _harbor->getReservedDock(pair.second);
+		// set its destination to the assigned dock's position
+		dest = _harbor->getDockPosition(dockId);
 
-		// If it has an assigned dock (which it SHOULD REALLY have)
-		if(dockId != 0)
+		_log << info << "Ship " << s->name()
+		<< " at " << source
+		<< " owns dock n°" << dockId
+		<< " located at " << dest << endl;
+
+		// A Ship stepping aside (see backOff) does nothing else
+		auto const b(find_if(_backOffs.begin(), _backOffs.end(),
+			[s](pair<Ship const *, Point> const & o)
+			{
+				return o.first == s;
+			}));
+		if(b != _backOffs.end())
 		{
-			// set its destination to the assigned dock's position
-			dest = _harbor->getDockPosition(dockId);
+			Point const aside(b->second);
+			_backOffs.erase(b);
+
+			if(s->engineFails())
+			{
+				_log << info << "\t[Engine failure] " << source
+				<< endl;
+				Metrics::increment(ENGINE_FAILURES);
+			}
+			else if(_harbor->getShipAt(aside) == nullptr)
+			{
+				_log << info << "\t[Back off] " << source << " -> "
+				<< aside << endl;
+				_plannedMovements.push_back({s, source, aside});
+			}
+
+			s->setState(ROUTING);
+			return true;
+		}
+
+		// Trace the roadmap and update the Ship's state
+		bool blocked(false);
+		bool const moving(traceRoute(source, dest, &blocked));
 
-			_log << info << "Ship " << pair.second->name()
-			<< " at " << pair.first
-			<< " owns dock n°"
-			<< _harbor->getReservedDock(pair.second)
-			<< " located at " << dest << endl;
+		if(!moving && s->state() != DOCKED)
+			++_dockings;
 
-			// Trace the roadmap
-			movementNeeded = traceRoute(source, dest);
+		s->setState(!moving ? DOCKED : blocked ? BLOCKED : ROUTING);
+		return moving;
+	}
+	else
+	{
+		_log << error << "[CRITICAL] In spite of all our"
+		<< "efforts, a Ship managed to go without an assigned"
+		<< "dock. Please submit a bug report to the developper."
+		<< endl;
+		return false;
+	}
+}
 
-			// Update the global movements flag
-			allDestinationsReached &= !movementNeeded;
+// Plan the given Ship's movements from the next cycle on
+void Tower::activate(Ship const * const s)
+{
+	if(Flags::events())
+		_events.push({_cycle + 1, MOVE, s, 0});
+	else
+		_active.push_back(s);
+}
+
+// Wake the Ships concerned by the cells changed since the last planning:
+// those shifted off their docks (a move planned past a blocked one shifts
+// whichever Ship stands there) and the blocked ones next to a change
+void Tower::wakeShips()
+{
+	static Point const around[] = {Point(0, 0), Point(1, 0), Point(-1, 0),
+					Point(0, 1), Point(0, -1)};
+	Ship const * s(nullptr);
+
+	for(Point const & p : _harbor->changedCells())
+	{
+		s = _harbor->getShipAt(p);
+
+		if(s != nullptr && s->state() == DOCKED
+		&& p != _harbor->getDockPosition(_harbor->getReservedDock(s)))
+		{
+			s->setState(ROUTING);
+			activate(s);
 		}
-		else
+
+		for(Point const & d : around)
 		{
-			_log << error << "[CRITICAL] In spite of all our"
-			<< "efforts, a Ship managed to go without an assigned"
-			<< "dock. Please submit a bug report to the developper."
-			<< endl;
+			s = _harbor->getShipAt(p + d);
+
+			if(s != nullptr && s->state() == BLOCKED)
+			{
+				s->setState(ROUTING);
+				activate(s);
+			}
 		}
 	}
+}
+
+// Drop the Ships deleted meanwhile (crushed, evicted) from the given list,
+// then sort it in the surface's order without duplicates
+void Tower::prepare(vector<Ship const *> & ships)
+{
+	ships.erase(remove_if(ships.begin(), ships.end(),
+		[this](Ship const * s)
+		{
+			return _harbor->reverseSurface().count(s) == 0;
+		}), ships.end());
+
+	sort(ships.begin(), ships.end(),
+		[this](Ship const * a, Ship const * b)
+		{
+			return _harbor->getShipPosition(a)
+				< _harbor->getShipPosition(b);
+		});
 
-	return allDestinationsReached;
+	ships.erase(unique(ships.begin(), ships.end()), ships.end());
 }
 
-// Applies the planned movements to the Ships
+// Route search of the given Ship to the given destination (started over
+// if the destination changed)
+Route * Tower::route(Ship const * const s, Point const & dest)
+{
+	auto it(lower_bound(_routes.begin(), _routes.end(),
+				make_pair(s, (Route *) nullptr)));
+
+	if(it == _routes.end() || it->first != s)
+	{
+		// (reserveRoutes keeps one per Ship on the surface)
+		if(_spareRoutes.empty())
+			_spareRoutes.push_back(
+				Route::create(_harbor, _clusters));
+
+		it = _routes.insert(it, make_pair(s, _spareRoutes.back()));
+		_spareRoutes.pop_back();
+		it->second->reset(s, dest);
+	}
+	else if(it->second->goal() != dest)
+		it->second->reset(s, dest);
+
+	return it->second;
+}
+
+// Build the route searches ahead (outside of the planning), so that every
+// Ship on the surface may get one
+void Tower::reserveRoutes()
+{
+	if(Flags::routing() == STRAIGHT)
+		return;
+
+	while(_routes.size() + _spareRoutes.size() < _harbor->surface().size())
+		_spareRoutes.push_back(Route::create(_harbor, _clusters));
+}
+
+// Set the searches of the Ships deleted (crushed, evicted...), docked or
+// leaving aside, before their addresses get reused
+void Tower::releaseRoutes()
+{
+	auto kept(_routes.begin());
+
+	for(auto const & r : _routes)
+		if(_harbor->reverseSurface().count(r.first) > 0
+		&& r.first->state() != DOCKED && r.first->state() != LEAVING)
+			*kept++ = r;
+		else
+			_spareRoutes.push_back(r.second);
+
+	_routes.erase(kept, _routes.end());
+}
+
+// Repair the searches around the cells changed since the last planning
+// (the hierarchical ones share their map: it is updated once for all)
+void Tower::repairRoutes()
+{
+	releaseRoutes();
+
+	if(_clusters != nullptr)
+		for(Point const & p : _harbor->changedCells())
+			_clusters->update(p);
+	else
+		for(auto const & r : _routes)
+			for(Point const & p : _harbor->changedCells())
+				r.second->update(p);
+}
+
+// Straight routing step from the given Point to the given destination,
+// away from the busiest lane: along the largest delta unless the other
+// productive axis is cooler by more than one step's worth of heat
+Direction Tower::steer(Point const & from, Point const & dest) const
+{
+	Point const delta(dest - from);
+	Direction const first(delta);
+	Direction second;
+	float const weight(Flags::congestion());
+
+	if(delta.x() == 0 || delta.y() == 0)
+		return first;
+
+	if(first == LEFT || first == RIGHT)
+		second = delta.y() > 0 ? DOWN : UP;
+	else
+		second = delta.x() > 0 ? RIGHT : LEFT;
+
+	HeatMap const & heat(_harbor->heat());
+	if(weight * heat.at(from + second) + 1.f
+	< weight * heat.at(from + first))
+		return second;
+
+	return first;
+}
+
+// Applies the planned movements to the Ships which planned them (refused
+// ones are recorded as waits): the steps following a refused one are
+// dropped, lest they moved whichever Ship came onto their source
 void Tower::applyPlannedMovements()
 {
-	// For each planned movement (first = source , second = dest)
-	for(auto pair : _plannedMovements)
+	// Number of moves actually applied (as harbor_moves_total counts
+	// them: a Ship crushing another one stays where it is)
+	unsigned moves(0);
+	Ship const * blocker;
+
+	// Let the traffic of the previous cycles fade out
+	_harbor->coolDown(_cycle);
+
+	// For each planned movement
+	for(Movement const & m : _plannedMovements)
 	{
-		_harbor->moveShip(pair.first, pair.second);
+		if(_harbor->getShipAt(m.source) != m.ship)
+			continue;
+
+		blocker = _harbor->getShipAt(m.destination);
+
+		if(_harbor->moveShip(m.source, m.destination))
+			moves += blocker == nullptr;
+		else if(blocker != nullptr)
+			wait(m.ship, blocker);
 	}
 
 	// Clear the planned movements list
 	_plannedMovements.clear();
+
+	// Ships may have been crushed
+	releaseRoutes();
+
+	Metrics::observe(CYCLE_MOVES, moves);
+}
+
+// Record that the given Ship was kept from moving by the other one during
+// the cycle (leaving Ships queue up behind their exit instead, see
+// planEvacuation, and docked ones do not want to move)
+void Tower::wait(Ship const * const s, Ship const * const blocker)
+{
+	if(s->state() != LEAVING && s->state() != DOCKED)
+		_blockers.push_back(make_pair(s, blocker));
+}
+
+// Build the cycle's wait-for graph (the first wait of each Ship, if both
+// Ships are still side by side) and break its deadlocks: in a cycle of
+// waits, the lowest priority Ship steps aside; a Ship waiting on a docked
+// one (which will not move) or on the same one for WAIT_PATIENCE cycles
+// takes another dock if it stands on its own (see redock), else steps
+// aside
+void Tower::resolveWaits()
+{
+	unsigned order(0);
+
+	// Back offs are planned in the cycle following theirs at most
+	_backOffs.clear();
+	_lastWaits.swap(_waits);
+	_waits.clear();
+
+	// Broken waits are forgotten after a while
+	_brokenWaits.erase(remove_if(_brokenWaits.begin(), _brokenWaits.end(),
+		[this](Wait const & w)
+		{
+			return w.broken + WAIT_MEMORY < _cycle;
+		}), _brokenWaits.end());
+
+	for(auto const & b : _blockers)
+		if(_harbor->reverseSurface().count(b.first) > 0
+		&& _harbor->reverseSurface().count(b.second) > 0)
+		{
+			Point const p(_harbor->getShipPosition(b.first));
+			Point const n(_harbor->getShipPosition(b.second));
+
+			if(abs(n.x() - p.x()) + abs(n.y() - p.y()) == 1)
+				_waits.push_back({b.first, b.second, p, n, 1,
+							order++, 0});
+		}
+	_blockers.clear();
+
+	if(_waits.empty())
+		return;
+
+	// By position, the first recorded wait of a Ship first
+	sort(_waits.begin(), _waits.end(),
+		[](Wait const & a, Wait const & b)
+		{
+			return a.position < b.position
+				|| (a.position == b.position
+				&& a.mark < b.mark);
+		});
+	_waits.erase(unique(_waits.begin(), _waits.end(),
+		[](Wait const & a, Wait const & b)
+		{
+			return a.position == b.position;
+		}), _waits.end());
+
+	// Waits going on since the previous cycle, or broken lately between
+	// the same Ships (their age goes on)
+	auto last(_lastWaits.cbegin());
+	for(Wait & w : _waits)
+	{
+		w.mark = 0;
+
+		while(last != _lastWaits.cend() && last->position < w.position)
+			++last;
+
+		if(last != _lastWaits.cend() && last->position == w.position
+		&& last->ship == w.ship && last->blocker == w.blocker)
+		{
+			w.cycles += last->cycles;
+			w.broken = last->broken;
+		}
+		else
+			for(Wait const & b : _brokenWaits)
+				if(b.ship == w.ship && b.blocker == w.blocker)
+				{
+					w.cycles += b.cycles;
+					w.broken = b.broken;
+				}
+	}
+
+	// Follow the waits from each Ship (one per Ship at most): a walk
+	// running into itself found a cycle
+	for(unsigned i = 0 ; i < _waits.size() ; ++i)
+	{
+		unsigned j(i);
+
+		while(j < _waits.size() && _waits[j].mark == 0)
+		{
+			_waits[j].mark = i + 1;
+
+			Wait key(_waits[j]);
+			key.position = key.next;
+			j = lower_bound(_waits.begin(), _waits.end(), key,
+				[](Wait const & a, Wait const & b)
+				{
+					return a.position < b.position;
+				}) - _waits.begin();
+
+			if(j < _waits.size()
+			&& _waits[j].position != key.position)
+				j = _waits.size();
+		}
+
+		if(j < _waits.size() && _waits[j].mark == i + 1)
+			breakCycle(j);
+	}
+
+	// Endless waits (but those of a cycle, handled above): a Ship kept
+	// from its dock by the Ship standing on it is given another dock,
+	// else steps aside to let it leave
+	for(Wait & w : _waits)
+		if(w.cycles > 0 && w.mark != UINT_MAX
+		&& (w.cycles >= WAIT_PATIENCE || w.blocker->state() == DOCKED))
+		{
+			if(squatted(w) ? redock(w) || backOff(w.ship, w.next)
+					: backOff(w.ship, w.next))
+			{
+				_log << info << "[Deadlock] Ship " << w.ship->name()
+				<< " waited " << w.cycles << " cycle(s) on Ship "
+				<< w.blocker->name() << endl;
+				Metrics::increment(DEADLOCKS);
+				w.cycles = 0;
+			}
+		}
+}
+
+// Break the cycle of waits going through the given one: a Ship of a cycle
+// formed again (or lasting) whose dock is taken by its blocker is given
+// another dock, else its Ships try to step aside by increasing priority
+// (then position) until one can. The waits keep their age, in case the
+// cycle forms again
+void Tower::breakCycle(unsigned const first)
+{
+	unsigned i(first);
+
+	_ring.clear();
+	do
+	{
+		_ring.push_back(i);
+		_waits[i].mark = UINT_MAX;
+
+		Wait key(_waits[i]);
+		key.position = key.next;
+		i = lower_bound(_waits.begin(), _waits.end(), key,
+			[](Wait const & a, Wait const & b)
+			{
+				return a.position < b.position;
+			}) - _waits.begin();
+	}
+	while(i != first);
+
+	sort(_ring.begin(), _ring.end(),
+		[this](unsigned const a, unsigned const b)
+		{
+			unsigned const pa(_waits[a].ship->priority()),
+					pb(_waits[b].ship->priority());
+
+			return pa < pb || (pa == pb
+				&& _waits[a].position < _waits[b].position);
+		});
+
+	for(unsigned const r : _ring)
+		if((_waits[r].broken > 0 || _waits[r].cycles >= WAIT_PATIENCE)
+		&& squatted(_waits[r]) && redock(_waits[r]))
+		{
+			_log << info << "[Deadlock] " << _ring.size()
+			<< " Ships waiting on each other again: Ship "
+			<< _waits[r].ship->name() << " docks elsewhere" << endl;
+			Metrics::increment(DEADLOCKS);
+			forgetCycle();
+			return;
+		}
+
+	for(unsigned const r : _ring)
+		if(backOff(_waits[r].ship, _waits[r].next))
+		{
+			_log << info << "[Deadlock] " << _ring.size()
+			<< " Ships waiting on each other: Ship "
+			<< _waits[r].ship->name() << " gives way" << endl;
+			Metrics::increment(DEADLOCKS);
+			rememberCycle();
+			return;
+		}
+}
+
+// Remember the waits of the cycle just broken by a back off, with their
+// age (see WAIT_MEMORY)
+void Tower::rememberCycle()
+{
+	for(unsigned const r : _ring)
+	{
+		Wait const & w(_waits[r]);
+		auto b(find_if(_brokenWaits.begin(), _brokenWaits.end(),
+			[&w](Wait const & o)
+			{
+				return o.ship == w.ship && o.blocker == w.blocker;
+			}));
+
+		_waits[r].broken = _cycle;
+
+		// The oldest one makes room when full (no allocation)
+		if(b != _brokenWaits.end())
+			*b = w;
+		else if(_brokenWaits.size() < _brokenWaits.capacity())
+			_brokenWaits.push_back(w);
+		else
+			*min_element(_brokenWaits.begin(), _brokenWaits.end(),
+				[](Wait const & x, Wait const & y)
+				{
+					return x.broken < y.broken;
+				}) = w;
+	}
+}
+
+// Forget the waits of the cycle just broken for good (by a new dock)
+void Tower::forgetCycle()
+{
+	for(unsigned const r : _ring)
+		_brokenWaits.erase(remove_if(_brokenWaits.begin(),
+			_brokenWaits.end(),
+			[this, r](Wait const & o)
+			{
+				return o.ship == _waits[r].ship
+					&& o.blocker == _waits[r].blocker;
+			}), _brokenWaits.end());
+}
+
+// Tells whether the given wait's blocker stands on the waiting Ship's dock
+bool Tower::squatted(Wait const & w) const
+{
+	return _harbor->getDockPosition(_harbor->getReservedDock(w.ship))
+		== w.next;
+}
+
+// Have the given Ship step aside (in the next planning) from the Ship in
+// its way at the given position: to the side nearer to its dock, else to
+// the other one, else backwards, onto a free cell (docks only if nothing
+// else is free) and returns true if it found one
+bool Tower::backOff(Ship const * const s, Point const & blocker)
+{
+	Point const position(_harbor->getShipPosition(s));
+	Point const ahead(blocker - position);
+	Point const side(ahead.y(), ahead.x());
+	Point const dock(_harbor->getDockPosition(
+				_harbor->getReservedDock(s)));
+	Point cells[] = {position + side, position - side, position - ahead};
+
+	Point const left(dock - cells[0]), right(dock - cells[1]);
+	if(abs(right.x()) + abs(right.y()) < abs(left.x()) + abs(left.y()))
+		swap(cells[0], cells[1]);
+
+	for(unsigned pass = 0 ; pass < 2 ; ++pass)
+		for(Point const & c : cells)
+		{
+			if(c.x() < 0 || c.y() < 0
+			|| unsigned(c.x()) >= _harbor->width()
+			|| unsigned(c.y()) >= _harbor->height()
+			|| _harbor->getShipAt(c) != nullptr
+			|| (pass == 0
+			&& _harbor->reverseDockMap().count(c) > 0)
+			|| find_if(_backOffs.begin(), _backOffs.end(),
+				[&c](pair<Ship const *, Point> const & o)
+				{
+					return o.second == c;
+				}) != _backOffs.end())
+				continue;
+
+			_log << info << "Ship " << s->name() << " at " << position
+			<< " backs off to " << c << endl;
+			_backOffs.push_back(make_pair(s, c));
+			Metrics::increment(BACK_OFFS);
+
+			if(s->state() == BLOCKED)
+			{
+				s->setState(ROUTING);
+				activate(s);
+			}
+			return true;
+		}
+
+	return false;
+}
+
+// Give the waiting Ship of the given wait, whose dock the blocker stands
+// on, another dock: the blocker's if both accept the other's dock (the
+// blocker takes the waiting Ship's), else the nearest available one it
+// accepts, and returns true if it got one
+bool Tower::redock(Wait const & w)
+{
+	unsigned const dock(_harbor->getReservedDock(w.ship)),
+			other(_harbor->getReservedDock(w.blocker));
+	unsigned nearest(0), distance(UINT_MAX);
+
+	_swaps.clear();
+
+	if(w.ship->accept(other) && w.blocker->accept(dock))
+	{
+		_swaps.push_back(make_pair(w.ship, other));
+		_swaps.push_back(make_pair(w.blocker, dock));
+	}
+	else
+	{
+		for(unsigned const d : _harbor->availableDocks())
+			if(w.ship->accept(d))
+			{
+				Point const delta(_harbor->getDockPosition(d)
+							- w.position);
+				unsigned const l(abs(delta.x())
+						+ abs(delta.y()));
+
+				if(l < distance)
+				{
+					nearest = d;
+					distance = l;
+				}
+			}
+
+		if(nearest == 0)
+			return false;
+
+		_swaps.push_back(make_pair(w.ship, nearest));
+	}
+
+	_harbor->reassignDocks(_swaps);
+	Metrics::increment(REASSIGNMENTS, _swaps.size());
+
+	// Both head elsewhere (a swapped blocker is already there)
+	for(auto const & change : _swaps)
+		if(change.first->state() == BLOCKED)
+		{
+			change.first->setState(ROUTING);
+			activate(change.first);
+		}
+
+	return true;
 }
 
-// Extracts Ships from the waiting queue (if any) or
-// creates new Ships if docks are available for reservation
-// and tries to insert them and reserve docks
-void Tower::manageNewShips(unsigned const proba)
+// Count the cycles in a row without progress: no Ship docked, nor did the
+// given progress happen (Ships leaving, or none left to move). Moves alone
+// do not count, they may go round in circles. Tells whether the cycle loop
+// may go on (see --watchdog)
+bool Tower::watch(bool const progress)
 {
-	// Random number for Ship Generation Event
-	unsigned randomNumber(Die::roll(1, 100));
+	_stalledCycles = progress || _dockings > 0 ? 0 : _stalledCycles + 1;
+	_dockings = 0;
 
+	if(Flags::watchdog() == 0 || _stalledCycles < Flags::watchdog())
+		return true;
+
+	_log << error << "[Livelock] No Ship docked or left for "
+	<< _stalledCycles << " cycles: giving up" << endl;
+	_livelocked = true;
+	return false;
+}
+
+// Whether the watchdog ended a loop (see --watchdog)
+bool Tower::livelocked() const
+{
+	return _livelocked;
+}
+
+// Sample the gauges and close the cycle's metrics
+void Tower::sampleMetrics()
+{
+	Metrics::set(QUEUE_LENGTH, _shipQueue.size());
+	Metrics::set(AVAILABLE_DOCKS, _harbor->availableDocks().size());
+	Metrics::set(SHIPS_ON_SURFACE, _harbor->surface().size());
+	Metrics::set(STALLED_CYCLES, _stalledCycles);
+	Metrics::increment(SHIP_CYCLES, _harbor->surface().size());
+	Metrics::cycle();
+}
+
+// Creates the cycle's (given number of) new Ships while docks are
+// available for their reservation, queues them, then inserts queued
+// Ships onto every free entry point and tries to reserve docks for them
+void Tower::manageNewShips(unsigned arrivals)
+{
 	// Current Ship we're working on
 	Ship const * s;
 
-	// If the random Ship creation event occurs,
-	if(randomNumber < proba &&
-	_harbor->availableDocks().size() - _shipQueue.size() > 0)
-		s = createShip();
-
-	else if(_shipQueue.size() > 0)
+	// Every queued Ship will need a dock: turn the others away
+	while(arrivals > 0
+	&& _harbor->availableDocks().size() > _shipQueue.size())
 	{
-		s = _shipQueue.front();
-		_shipQueue.pop_front();
+		s = createShip();
+		_shipQueue.push(s, _cycle);
+		--arrivals;
 
 		_log << info << "Ship " << s->name()
-		<< " was popped from the waiting queue (queue size is now "
+		<< " joined the waiting queue (queue size is now "
 		<< _shipQueue.size() << ")" << endl;
 	}
-	else	// we'll manage a whole bunch of nothing :)
-		s = nullptr;
 
-	// If we got some Ship to insert into the Harbor
-	if(s != nullptr)
-		insertShip(s);
+	if(arrivals > 0)
+		Metrics::increment(TURNED_AWAY, arrivals);
+
+	// Insert the queued Ships (by aged priority, see ShipQueue) as long
+	// as an entry point is free
+	for(auto entry : _harbor->entryPoints())
+		while(!_shipQueue.empty() && _harbor->getShipAt(entry) == nullptr)
+		{
+			s = _shipQueue.pop();
+
+			_log << info << "Ship " << s->name()
+			<< " was popped from the waiting queue (queue size is now "
+			<< _shipQueue.size() << ")" << endl;
+
+			insertShip(s);
+		}
 }
 
 // Replace the original Ship's reservation with
@@ -406,8 +1452,12 @@ bool Tower::replaceReservation(Ship const * const original,
 	// Remove the original Ship from the surface
 	// (this also resiliates its dock reservation)
 	if(_harbor->removeShip(original))
-		// and delete it
+	{
+		// and delete it (along with its route)
+		releaseRoutes();
 		delete original;
+		Metrics::increment(EVICTIONS);
+	}
 	else
 	{
 		_log << error << "Failed to delete Ship " << original->name()
@@ -436,16 +1486,14 @@ bool Tower::assignDock(Ship const * const ship)
 	// Assignation success flag
 	bool success(false);
 
-	// Priorities, dock acceptance
-	unsigned p1, p2;
-	bool accept(false);
-
-	// Available docks iterator, surface iterator
-	set<unsigned>::const_iterator
+	// Available docks iterator
+	DockSet::const_iterator
 		dit(_harbor->availableDocks().begin());
 
-	map<Point, Ship const *>::const_iterator
-		sit(_harbor->surface().begin());
+	TraceScope span("assignDock", "dock");
+
+	if(span.enabled())
+		span.arg("ship", ship->name());
 
 
 	// Step 1: try using the available docks (if any)
@@ -471,43 +1519,123 @@ bool Tower::assignDock(Ship const * const ship)
 		// segfault).
 	}
 
-	// Step 2: try replacing a Ship with inferior priority
-	while(!success && sit != _harbor->surface().end())
+	// Step 2: try replacing the lowest priority Ship holding a dock
+	// our Ship accepts (see PreemptionIndex)
+	if(!success)
 	{
-		// Skip the requesting ship itself to prevent
-		// critical errors
-		if(sit->second == ship)
-			sit++;
+		Ship const * victim(_harbor->evictionCandidate(ship));
 
-		// Check priorities
-		p1 = sit->second->priority();
-		p2 = ship->priority();
-		// Simulate dock proposal to our Ship
-		accept = ship->accept(_harbor->getReservedDock(sit->second));
-
-		_log << info << "\tProbing dock "
-		<< _harbor->getReservedDock(sit->second)
-		<< " : Ship " << sit->second->name() << " has priority " << p1
-		<< " , while " << ship->name() << " has priority " << p2 << endl;
-
-		if(p1 < p2 && accept)
+		if(victim != nullptr)
 		{
-			_log << info << "\t" << ship->name()
-			<< " wins and accepts dock "
-			<< _harbor->getReservedDock(sit->second) << endl;
+			_log << info << "\t" << ship->name() << " (priority "
+			<< ship->priority() << ") wins and accepts dock "
+			<< _harbor->getReservedDock(victim) << " from Ship "
+			<< victim->name() << " (priority " << victim->priority()
+			<< ")" << endl;
 
 			// Try replacing the lower-priority Ship's reservation
-			success = replaceReservation(sit->second, ship);
+			success = replaceReservation(victim, ship);
 		}
-
-		// If the replacement failed, try the next one
-		if(!success)
-			sit++;
 	}
 
 	return success;
 }
 
+// Reassign the docks of the (first DOCK_BATCH_SIZE) Ships still travelling
+// so as to minimize the sum of their priority-weighted distances to their
+// docks (see DockMatcher). The next Ships to leave the queue also take
+// part, from the entry point, so that the free docks they'll need are kept
+// for them; they still get their actual dock once inserted.
+void Tower::batchAssignDocks()
+{
+	unsigned travelling(0);
+	Point const entry(*_harbor->entryPoints().begin());
+
+	_batchShips.clear();
+	_batchOrigins.clear();
+	_batchDocks.clear();
+	_batchDockPositions.clear();
+	_batchChanges.clear();
+
+	// Travelling Ships and their current docks
+	for(auto const & cell : _harbor->surface())
+	{
+		unsigned const dockId(_harbor->getReservedDock(cell.second));
+
+		if(_batchShips.size() == DOCK_BATCH_SIZE)
+			break;
+
+		if(dockId == 0 || _harbor->getDockPosition(dockId) == cell.first)
+			continue;
+
+		_batchShips.push_back(cell.second);
+		_batchOrigins.push_back(cell.first);
+		_batchDocks.push_back(dockId);
+	}
+	travelling = _batchShips.size();
+
+	if(travelling == 0)
+		return;
+
+	// Free docks
+	for(unsigned dockId : _harbor->availableDocks())
+		_batchDocks.push_back(dockId);
+
+	// Next queued Ships, in serving order (as many as there are free
+	// docks left)
+	_shipQueue.next(min<unsigned>(DOCK_BATCH_SIZE, _batchDocks.size())
+			- travelling, _batchShips);
+	_batchOrigins.resize(_batchShips.size(), entry);
+
+	for(unsigned dockId : _batchDocks)
+		_batchDockPositions.push_back(_harbor->getDockPosition(dockId));
+
+	// Priority-weighted Manhattan distances (a dock refused by a
+	// travelling Ship costs more than every queued Ship's refusals
+	// together: queued Ships never push travelling ones off their docks)
+	_matcher.reset(_batchShips.size(), _batchDocks.size());
+
+	for(unsigned i = 0 ; i < _batchShips.size() ; ++i)
+		for(unsigned j = 0 ; j < _batchDocks.size() ; ++j)
+		{
+			Point const d(_batchDockPositions[j] - _batchOrigins[i]);
+
+			if(_batchShips[i]->accept(_batchDocks[j]))
+				_matcher.setCost(i, j,
+					(long long)_batchShips[i]->priority()
+					* (abs(d.x()) + abs(d.y())));
+			else
+				_matcher.setCost(i, j, DOCK_MATCHER_FORBIDDEN
+					* (i < travelling ? DOCK_BATCH_SIZE : 1));
+		}
+
+	_matcher.solve();
+
+	// Apply the travelling Ships' new docks (all or nothing)
+	for(unsigned i = 0 ; i < travelling ; ++i)
+	{
+		unsigned const j(_matcher.column(i));
+
+		if(_matcher.cost(i, j) >= DOCK_MATCHER_FORBIDDEN)
+			return;
+
+		if(j != i)
+			_batchChanges.push_back(make_pair(_batchShips[i],
+							_batchDocks[j]));
+	}
+
+	_harbor->reassignDocks(_batchChanges);
+	Metrics::increment(REASSIGNMENTS, _batchChanges.size());
+
+	// Blocked Ships may now head elsewhere
+	for(auto const & change : _batchChanges)
+		if(change.first->state() == BLOCKED)
+		{
+			change.first->setState(ROUTING);
+			activate(change.first);
+		}
+}
+
 // Try to insert the given Ship into the Harbor and
 // reserve a dock for it
 void Tower::insertShip(Ship const * const s)
@@ -532,33 +1660,45 @@ void Tower::insertShip(Ship const * const s)
 	// If we managed to insert the Ship on an entry point,
 	if(shipInserted)
 	{
-		_log << info << "Ship " << s
+		_log << info << "Ship " << s->name()
 		<< " successfully entered the Harbor at "
 		<< _harbor->getShipPosition(s) << endl;
 
 		// try assigning it a dock
 		dockReserved = assignDock(s);
 
+		// Size the planned movements for every Ship's steps, so that
+		// planning never has to grow them
+		_plannedMovements.reserve(_harbor->totalSpeed());
+
+		// The Ship moves from the next cycle on
+		if(dockReserved)
+		{
+			activate(s);
+			reserveRoutes();
+		}
+
 		// If we fail to assign a dock to the newly
 		// inserted Ship
 		if(!dockReserved)
 		{
 			_log << warn << "No suitable docks were found for Ship "
-			<< s << " : this Ship will be deleted!" << endl;
+			<< s->name() << " : this Ship will be deleted!" << endl;
 
 			// Remove it from the surface
 			// and delete it (no other solution)
 			_harbor->removeShip(s);
 			delete s;
+			Metrics::increment(SHIPS_REJECTED);
 		}
 	}
 	// If we fail to insert it on an entry point
 	else
 	{
 		// Put in in waiting line
-		_shipQueue.push_back(s);
+		_shipQueue.push(s, _cycle);
 
-		_log << info << "Ship " << s
+		_log << info << "Ship " << s->name()
 		<< " joined the waiting queue (queue size is now "
 		<< _shipQueue.size() << ")" << endl;
 	}
@@ -569,8 +1709,8 @@ void Tower::insertShip(Ship const * const s)
 Ship const * Tower::createShip()
 {
 	// Random settings
-	unsigned factoryType(Die::roll(1, 2));
-	unsigned shipType(Die::roll(1, 4));
+	unsigned factoryType(Die::roll(Config::factories()));
+	unsigned shipType(Die::roll(Config::ships()));
 
 	// Factory and Ship interfaces pointers
 	Factory * f(nullptr);
@@ -580,12 +1720,12 @@ Ship const * Tower::createShip()
 	switch(factoryType)
 	{
 		default:
-		case 1:
+		case 0:
 			_log << info << "Prestigious Manufactory";
 			f = new PrestigiousManufactory();
 		break;
 
-		case 2:
+		case 1:
 			_log << info << "Low Cost Manufactory";
 			f = new LowCostManufactory();
 		break;
@@ -596,22 +1736,22 @@ Ship const * Tower::createShip()
 	switch(shipType)
 	{
 		default:
-		case 1:
+		case 0:
 			_log << info << "Passenger Ship" << endl;
 			s = new PassengerShip(f);
 		break;
 
-		case 2:
+		case 1:
 			_log << info << "Military Ship" << endl;
 			s = new MilitaryShip(f);
 		break;
 
-		case 3:
+		case 2:
 			_log << info << "Pleasure Craft" << endl;
 			s = new PleasureCraft(f);
 		break;
 
-		case 4:
+		case 3:
 			_log << info << "Fishing Boat" << endl;
 			s = new FishingBoat(f);
 		break;
@@ -622,6 +1762,7 @@ Ship const * Tower::createShip()
 	// Log the newly created Ship's identity
 	// in ships.xml
 	s->accept(&_xml);
+	Metrics::increment(SHIPS_CREATED);
 
 	return s;
 }
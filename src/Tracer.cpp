@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2016 Julien "Derjik" Laurent <julien.laurent@engineer.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "../include/Tracer.hpp"
+
+#include <fstream>		// std::ofstream
+#include <iostream>		// std::cout, std::endl
+#include <iomanip>		// std::setprecision
+#include "../include/Flags.hpp"	// Flags
+
+using namespace std;
+
+
+thread_local Tracer::Buffer * Tracer::_local(nullptr);
+vector<Tracer::Buffer *> Tracer::_buffers;
+mutex Tracer::_buffersMutex;
+chrono::steady_clock::time_point const
+	Tracer::_origin(chrono::steady_clock::now());
+
+
+TraceScope::TraceScope(char const * name, char const * category)
+	: _name(name), _category(category),
+	_enabled(!Flags::traceFile().empty()), _start(0), _argName(nullptr)
+{
+	if(_enabled)
+		_start = Tracer::now();
+}
+
+TraceScope::~TraceScope()
+{
+	if(_enabled)
+		Tracer::complete(_name, _category, _start, Tracer::now(),
+				_argName, _argValue);
+}
+
+
+// Get (or create) the calling thread's buffer
+Tracer::Buffer & Tracer::local()
+{
+	if(_local == nullptr)
+	{
+		lock_guard<mutex> lock(_buffersMutex);
+
+		_local = new Buffer;
+		_local->tid = _buffers.size() + 1;
+		_buffers.push_back(_local);
+	}
+
+	return *_local;
+}
+
+uint64_t Tracer::now()
+{
+	return chrono::duration_cast<chrono::nanoseconds>(
+		chrono::steady_clock::now() - _origin).count();
+}
+
+void Tracer::complete(char const * name, char const * category,
+		uint64_t const start, uint64_t const end,
+		char const * argName, string const & argValue)
+{
+	Event e = {name, category, start, end - start, argName, argValue};
+
+	local().events.push_back(e);
+}
+
+// Escape a string for JSON output
+void Tracer::writeEscaped(ostream & out, string const & s)
+{
+	for(auto c : s)
+	{
+		if(c == '"' || c == '\\')
+			out << '\\' << c;
+		else if(c >= 0 && c < ' ')
+			out << ' ';
+		else
+			out << c;
+	}
+}
+
+// Write every buffered span (timestamps in microseconds)
+void Tracer::flush()
+{
+	lock_guard<mutex> lock(_buffersMutex);
+	bool first(true);
+
+	if(!Flags::traceFile().empty())
+	{
+		ofstream file(Flags::traceFile(), ios::trunc | ios::out);
+
+		if(!file)
+			cout << "Unable to write trace file \""
+			<< Flags::traceFile() << "\"" << endl;
+		else
+		{
+			file << fixed << setprecision(3);
+			file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+			for(auto buffer : _buffers)
+			{
+				// Thread name metadata
+				file << (first ? "\n" : ",\n")
+				<< "{\"ph\":\"M\",\"name\":\"thread_name\","
+				<< "\"pid\":1,\"tid\":" << buffer->tid
+				<< ",\"args\":{\"name\":\""
+				<< (buffer->tid == 1 ? "main" : "worker") << "\"}}";
+				first = false;
+
+				for(auto const & e : buffer->events)
+				{
+					file << ",\n{\"ph\":\"X\",\"pid\":1,\"tid\":"
+					<< buffer->tid << ",\"name\":\"" << e.name
+					<< "\",\"cat\":\"" << e.category
+					<< "\",\"ts\":" << e.start / 1e3
+					<< ",\"dur\":" << e.duration / 1e3;
+
+					if(e.argName != nullptr)
+					{
+						file << ",\"args\":{\"" << e.argName
+						<< "\":\"";
+						writeEscaped(file, e.argValue);
+						file << "\"}";
+					}
+					file << "}";
+				}
+			}
+
+			file << "\n]}\n";
+		}
+	}
+
+	for(auto buffer : _buffers)
+		delete buffer;
+	_buffers.clear();
+	_local = nullptr;
+}
@@ -21,17 +21,27 @@
  */
 
 #include <ctime>			// time()
+#include <iostream>			// std::cout
 #include <cstdlib>			// srand()
 #include "../include/Harbor.hpp"	// Harbor
 #include "../include/Tower.hpp"		// Tower
 #include "../include/Flags.hpp"		// Flags
 #include "../include/Die.hpp"		// Die
+#include "../include/Config.hpp"	// Config
+#include "../include/Metrics.hpp"	// Metrics
+#include "../include/Profiler.hpp"	// Profiler
+#include "../include/PerfCounters.hpp"	// PerfCounters
+#include "../include/Tracer.hpp"	// Tracer
+#include "../include/Scenario.hpp"	// Scenario
 
 using namespace std;
 
 
 int main(int argc, char* argv[])
 {
+	// Whether the watchdog ended the run (see --watchdog)
+	bool livelocked(false);
+
 	// Parse arguments
 	Flags::parse(argc, argv);
 
@@ -40,10 +50,22 @@ int main(int argc, char* argv[])
 	if(Flags::seedRNGs())
 		srand(time(nullptr));
 
+	// Load the probability tables, if any
+	if(!Flags::configFile().empty())
+		Config::load(Flags::configFile());
+
+	// Open the scenario to record or replay, if any
+	Scenario::open();
+
+	// Open the hardware counters, if permitted
+	if(Flags::profile())
+		PerfCounters::open();
+
 	if(Flags::runCycle())
 	{
 		// Instantiate the Harbor
-		Harbor * h(Harbor::getInstance(25,25));
+		Harbor * h(Harbor::getInstance(Flags::harborWidth(),
+						Flags::harborHeight()));
 
 		// Instantiate the Tower
 		Tower t(h);
@@ -54,21 +76,46 @@ int main(int argc, char* argv[])
 		// Begin out cycle
 		t.cycleOut();
 
+		livelocked = t.livelocked();
+
 		// Clean Harbor instance
 		Harbor::deleteInstance();
 		// Clean common RNG instance
 		Die::clean();
+
+		// Export the final metrics
+		Metrics::flush();
+		Metrics::clean();
+
+		// Write the buffered timeline
+		Tracer::flush();
 	}
 	else
 	{
 		Flags::printUsage();
 	}
 
+	// Print the phases timings (once the display is released)
+	Profiler::report(cout);
+	PerfCounters::close();
+
+	// Close the scenario (a replay reports its divergence, a recording
+	// is flushed) whatever the outcome of the run
+	Scenario::close();
+
 	if(Flags::help())
 	{
 		Flags::printHelp();
 	}
 
+	// Fail if a steady-state phase allocated, if the watchdog gave up on
+	// a livelock, or if the replayed scenario diverged
+	bool const allocated(Flags::zeroAllocations()
+				&& !Profiler::checkAllocations(cout));
+
+	if(allocated || livelocked || Scenario::drifted())
+		return 1;
+
 	return 0;
 }
 